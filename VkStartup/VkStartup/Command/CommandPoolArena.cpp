@@ -0,0 +1,113 @@
+#include "VkStartup/Command/CommandPoolArena.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Exceptions.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace VkStartup {
+
+CommandPoolArena::CommandPoolArena(VkDevice device,
+                                   std::unordered_map<VkShared::Enums::QueueFamily, uint32_t> queue_family_indices,
+                                   const uint32_t frame_count)
+    : m_vk_device{device},
+      m_queue_family_indices{std::move(queue_family_indices)},
+      m_frame_count{std::max(frame_count, 1u)},
+      m_frame_pools(m_frame_count) {
+}
+
+size_t CommandPoolArena::PoolKeyHash::operator()(const PoolKey& key) const {
+  size_t seed = std::hash<std::thread::id>{}(key.thread);
+  seed ^= std::hash<uint32_t>{}(key.frame_index) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  seed ^= std::hash<VkShared::Enums::QueueFamily>{}(key.family) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  return seed;
+}
+
+VkCommandBuffer CommandPoolArena::acquire(const uint32_t frame_index, const VkShared::Enums::QueueFamily family,
+                                          const VkCommandBufferLevel level) {
+  auto& [pool, primary, secondary] = frame_pool(frame_index, family);
+  return next_buffer(pool(), level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? primary : secondary, level);
+}
+
+CommandPoolArena::Pool& CommandPoolArena::frame_pool(const uint32_t frame_index,
+                                                     const VkShared::Enums::QueueFamily family) {
+  if (frame_index >= m_frame_count) {
+    VkError("Command pool frame index out of range: " + std::to_string(frame_index));
+    throw Exceptions::VkStartupException();
+  }
+
+  const PoolKey key{std::this_thread::get_id(), frame_index, family};
+  {
+    std::shared_lock lock{m_mutex};
+    if (const auto itr = m_pools.find(key); itr != m_pools.end()) {
+      return *itr->second;
+    }
+  }
+
+  // First use of this (thread, frame, family) combination
+  const auto family_itr = m_queue_family_indices.find(family);
+  if (family_itr == m_queue_family_indices.end()) {
+    VkError("No queue family index available for command pool creation");
+    throw Exceptions::VkStartupException();
+  }
+
+  auto new_pool = std::make_unique<Pool>();
+  new_pool->pool = VkCommandPoolHandle{
+      CreateInfo::vk_command_pool_create_info(family_itr->second, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT), m_vk_device};
+
+  std::unique_lock lock{m_mutex};
+  auto& created = *m_pools.emplace(key, std::move(new_pool)).first->second;
+  m_frame_pools[frame_index].push_back(&created);
+  return created;
+}
+
+VkCommandBuffer CommandPoolArena::next_buffer(VkCommandPool pool, CommandBuffers& buffers,
+                                              const VkCommandBufferLevel level) const {
+  // Recycle buffers from a previous use of this frame before allocating
+  if (buffers.used == buffers.buffers.size()) {
+    const auto grow_count = static_cast<uint32_t>(std::max<size_t>(buffers.buffers.size(), 4));
+    const auto info = CreateInfo::vk_command_buffer_allocate_info(pool, level, grow_count);
+    buffers.buffers.resize(buffers.buffers.size() + grow_count);
+    VkCheck(vkAllocateCommandBuffers(m_vk_device, &info, &buffers.buffers[buffers.used]),
+            Exceptions::VkStartupException());
+  }
+  return buffers.buffers[buffers.used++];
+}
+
+void CommandPoolArena::reset(const uint32_t frame_index) {
+  std::shared_lock lock{m_mutex};
+  for (auto* pool : m_frame_pools.at(frame_index)) {
+    VkCheck(vkResetCommandPool(m_vk_device, pool->pool(), 0), Exceptions::VkStartupException());
+    pool->primary.used = 0;
+    pool->secondary.used = 0;
+  }
+}
+
+void CommandPoolArena::reset(const uint32_t frame_index, VkFence frame_fence) {
+  VkCheck(vkWaitForFences(m_vk_device, 1, &frame_fence, VK_TRUE, UINT64_MAX), Exceptions::VkStartupException());
+  reset(frame_index);
+}
+
+uint32_t CommandPoolArena::release_thread(const std::thread::id thread) {
+  // Destroyed outside of the lock
+  std::vector<std::unique_ptr<Pool>> released{};
+  std::lock_guard lock{m_mutex};
+  for (auto itr = m_pools.begin(); itr != m_pools.end();) {
+    if (itr->first.thread != thread) {
+      ++itr;
+      continue;
+    }
+    std::erase(m_frame_pools[itr->first.frame_index], itr->second.get());
+    released.push_back(std::move(itr->second));
+    itr = m_pools.erase(itr);
+  }
+  return static_cast<uint32_t>(released.size());
+}
+
+uint32_t CommandPoolArena::frame_count() const {
+  return m_frame_count;
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,81 @@
+#pragma once
+#include "VkStartup/Handle/UsingHandle.h"
+#include "VkShared/Enums.h"
+#include <vulkan/vulkan_core.h>
+#include <memory>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace VkStartup {
+
+// Command pools keyed by (thread, frame index, queue family).  Each recording thread gets
+// its own pool per frame so no locking is required while recording.  Command buffers are
+// never freed individually; the whole pool is reset once the frame's GPU work completes
+// and its command buffers are handed out again.
+//
+// Pools are kept until the arena is destroyed.  Threads that exit before then (e.g. a
+// thread pool that churns workers) must call 'release_thread', otherwise their pools leak
+// for every frame & family they recorded.
+class CommandPoolArena {
+ public:
+  explicit CommandPoolArena(VkDevice device,
+                            std::unordered_map<VkShared::Enums::QueueFamily, uint32_t> queue_family_indices,
+                            uint32_t frame_count);
+
+  // Command buffer from the calling thread's pool.  The buffer is valid until the
+  // frame is reset.
+  [[nodiscard]] VkCommandBuffer acquire(uint32_t frame_index, VkShared::Enums::QueueFamily family,
+                                        VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+  // Reset every pool used by the frame.  The frame's GPU work must be complete and no
+  // thread may be recording into the frame's command buffers.
+  void reset(uint32_t frame_index);
+
+  // Waits for the frame's fence to signal before resetting
+  void reset(uint32_t frame_index, VkFence frame_fence);
+
+  // Destroys every pool of 'thread' (all frames & families).  The GPU work recorded by the
+  // thread must be complete.  Returns the number of pools destroyed.
+  uint32_t release_thread(std::thread::id thread = std::this_thread::get_id());
+
+  [[nodiscard]] uint32_t frame_count() const;
+
+ private:
+  struct PoolKey {
+    std::thread::id thread{};
+    uint32_t frame_index{0};
+    VkShared::Enums::QueueFamily family{};
+    bool operator==(const PoolKey& rhs) const = default;
+  };
+
+  struct PoolKeyHash {
+    size_t operator()(const PoolKey& key) const;
+  };
+
+  struct CommandBuffers {
+    std::vector<VkCommandBuffer> buffers{};
+    size_t used{0};
+  };
+
+  struct Pool {
+    VkCommandPoolHandle pool{};
+    CommandBuffers primary{};
+    CommandBuffers secondary{};
+  };
+
+  [[nodiscard]] Pool& frame_pool(uint32_t frame_index, VkShared::Enums::QueueFamily family);
+  [[nodiscard]] VkCommandBuffer next_buffer(VkCommandPool pool, CommandBuffers& buffers,
+                                            VkCommandBufferLevel level) const;
+
+  VkDevice m_vk_device{VK_NULL_HANDLE};
+  std::unordered_map<VkShared::Enums::QueueFamily, uint32_t> m_queue_family_indices{};
+  uint32_t m_frame_count{0};
+
+  std::shared_mutex m_mutex;
+  std::unordered_map<PoolKey, std::unique_ptr<Pool>, PoolKeyHash> m_pools{};
+  std::vector<std::vector<Pool*>> m_frame_pools{};
+};
+
+}  // namespace VkStartup
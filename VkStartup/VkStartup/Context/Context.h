@@ -4,6 +4,15 @@
 #include "VkStartup/Context/PhysicalDevice.h"
 #include "VkStartup/Context/SurfaceLoader.h"
 #include "VkStartup/Context/Renderpass.h"
+#include "VkStartup/Context/RenderpassCache.h"
+#include "VkStartup/Context/FramebufferCache.h"
+#include "VkStartup/Context/Rendering.h"
+#include "VkStartup/Sync/TimelineSemaphore.h"
+#include "VkStartup/Sync/DeletionQueue.h"
+#include "VkStartup/Context/PipelineCache.h"
+#include "VkStartup/Context/Frame.h"
+#include "VkStartup/Context/Offscreen.h"
+#include "VkStartup/Memory/MemoryBudget.h"
 #include "VkShared/Enums.h"
 #include <memory>
 
@@ -12,6 +21,8 @@ namespace VkStartup {
 struct QueueIndexHandle {
   uint32_t family_index{999};
   VkQueue handle{VK_NULL_HANDLE};
+  uint32_t queue_index{0};
+  float priority{1.0f};
 };
 
 struct VkSwapchainContext {
@@ -20,6 +31,14 @@ struct VkSwapchainContext {
   VkSwapchainHandle swapchain{};
   RenderpassBuffers rp_buffers{};
   QueueIndexHandle present_queue;
+  FrameRing frames{};
+
+  // Only used by offscreen targets (no surface loader)
+  OffscreenImages offscreen{};
+
+  [[nodiscard]] bool is_offscreen() const {
+    return !surface_loader;
+  }
 };
 
 struct VkContext {
@@ -27,11 +46,39 @@ struct VkContext {
   std::unique_ptr<VkDebugger> debugger{};
   PhysicalDeviceInfo phy_device_info{};
   VkDeviceHandle device{};
-  std::unordered_map<VkShared::Enums::QueueFamily, QueueIndexHandle> queues{};
+  // All queues created for each family.  Queues are only distinct when the family exposes
+  // enough of them; otherwise requests share a queue (see InitContextOptions::queue_priorities).
+  std::unordered_map<VkShared::Enums::QueueFamily, std::vector<QueueIndexHandle>> queues{};
+  // One timeline per distinct VkQueue.  Empty unless 'phy_device_info.timeline_semaphore' is set.
+  std::unordered_map<VkQueue, std::unique_ptr<QueueTimeline>> timelines{};
 
-  // Multiple surfaces to be drawn to
-  std::unordered_map<std::string, VkSwapchainContext> swap_ctx{};
+  // Declared before 'swap_ctx' so offscreen images are destroyed before the allocator
   VmaAllocatorHandle mem_alloc{};
+  // Per heap usage / budget of 'mem_alloc' and pressure callbacks (updated in 'begin_frame')
+  std::unique_ptr<MemoryBudget> memory_budget{};
+  // Multiple surfaces (or offscreen targets) to be drawn to
+  std::unordered_map<std::string, VkSwapchainContext> swap_ctx{};
+  std::unique_ptr<PipelineCache> pipeline_cache{};
+  // Core or KHR entry points.  Null unless 'phy_device_info.dynamic_rendering' is set.
+  PFN_vkCmdBeginRendering cmd_begin_rendering{nullptr};
+  PFN_vkCmdEndRendering cmd_end_rendering{nullptr};
+  // Core or KHR entry points.  Null unless 'phy_device_info.timeline_semaphore' is set.
+  PFN_vkWaitSemaphores wait_semaphores{nullptr};
+  PFN_vkSignalSemaphore signal_semaphore{nullptr};
+  PFN_vkGetSemaphoreCounterValue get_semaphore_counter_value{nullptr};
+  std::unique_ptr<RenderpassCache> renderpass_cache{};
+  // Declared last so framebuffers are destroyed before the views they reference
+  std::unique_ptr<FramebufferCache> framebuffer_cache{};
+  // Handles retired while the GPU may still use them (destroyed before everything above)
+  std::unique_ptr<DeletionQueue> deletion_queue{};
+
+  [[nodiscard]] const QueueIndexHandle& queue(const VkShared::Enums::QueueFamily family, const size_t index = 0) const {
+    return queues.at(family).at(index);
+  }
+
+  [[nodiscard]] QueueTimeline& timeline(const VkShared::Enums::QueueFamily family, const size_t index = 0) const {
+    return *timelines.at(queue(family, index).handle);
+  }
 
   [[nodiscard]] VkExtent2D swap_extent(const std::string& id) const {
     return swap_ctx.at(id).swap_format_details.extent;
@@ -0,0 +1,226 @@
+#include "VkStartup/Context/DebugMessageSink.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace VkStartup {
+
+namespace {
+
+template <size_t N>
+void copy_text(std::array<char, N>& destination, const char* source) {
+  if (!source) {
+    destination[0] = '\0';
+    return;
+  }
+  const size_t length = std::min(std::strlen(source), N - 1);
+  std::memcpy(destination.data(), source, length);
+  destination[length] = '\0';
+}
+
+std::string type_prefix(const VkDebugUtilsMessageTypeFlagsEXT type) {
+  if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT) {
+    return "[Performance] ";
+  }
+  if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) {
+    return "[Validation] ";
+  }
+  return "[General] ";
+}
+
+}  // namespace
+
+DebugMessageSink::DebugMessageSink(DebugMessageFilter filter)
+    : m_filter{std::move(filter)},
+      m_ring{m_filter.ring_capacity},
+      m_ids{std::make_unique<IdCount[]>(id_table_size)} {
+  if (m_filter.perf_report) {
+    m_perf_report = std::make_unique<PerfLintReport>();
+  }
+  if (m_filter.async) {
+    m_logger = std::thread{&DebugMessageSink::run, this};
+  }
+}
+
+DebugMessageSink::~DebugMessageSink() {
+  if (m_logger.joinable()) {
+    m_stop.store(true, std::memory_order_release);
+    m_wake.fetch_add(1, std::memory_order_release);
+    m_wake.notify_one();
+    m_logger.join();
+  }
+  summary();
+
+  if (m_perf_report && !m_filter.perf_report_path.empty()) {
+    if (m_perf_report->write_json(m_filter.perf_report_path)) {
+      VkInfo("Performance lint report (" + std::to_string(m_perf_report->total()) + " warnings) written to " +
+             m_filter.perf_report_path.string());
+    } else {
+      VkError("Unable to write the performance lint report to " + m_filter.perf_report_path.string());
+    }
+  }
+}
+
+void DebugMessageSink::submit(const VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+                              const VkDebugUtilsMessageTypeFlagsEXT type,
+                              const VkDebugUtilsMessengerCallbackDataEXT& data) {
+  if (!(severity & m_filter.severities) || !(type & m_filter.types)) {
+    return;
+  }
+
+  if (m_perf_report && (type & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT)) {
+    m_perf_report->record(data);
+  }
+
+  // Every occurrence is counted, including muted & rate limited ones
+  const uint64_t occurrence = count_id(data.messageIdNumber);
+  if (std::ranges::find(m_filter.muted_ids, data.messageIdNumber) != m_filter.muted_ids.end()) {
+    return;
+  }
+  if (m_filter.log_limit_per_id > 0 && occurrence > m_filter.log_limit_per_id) {
+    return;
+  }
+
+  Message message{};
+  message.severity = severity;
+  message.type = type;
+  message.id = data.messageIdNumber;
+  message.occurrence = occurrence;
+  copy_text(message.name, data.pMessageIdName);
+  copy_text(message.text, data.pMessage);
+
+  if (!m_filter.async) {
+    write(message);
+    return;
+  }
+  if (!m_ring.try_push(message)) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  m_pushed.fetch_add(1, std::memory_order_release);
+  m_wake.fetch_add(1, std::memory_order_release);
+  m_wake.notify_one();
+}
+
+void DebugMessageSink::flush() {
+  if (!m_logger.joinable()) {
+    return;
+  }
+  const uint64_t target = m_pushed.load(std::memory_order_acquire);
+  uint64_t logged = m_logged.load(std::memory_order_acquire);
+  while (logged < target) {
+    m_logged.wait(logged, std::memory_order_acquire);
+    logged = m_logged.load(std::memory_order_acquire);
+  }
+}
+
+std::vector<DebugMessageCount> DebugMessageSink::counts() const {
+  std::vector<DebugMessageCount> result{};
+  {
+    const std::lock_guard lock{m_names_mutex};
+    for (size_t i = 0; i < id_table_size; i++) {
+      const int64_t key = m_ids[i].key.load(std::memory_order_acquire);
+      if (key == empty_key) {
+        continue;
+      }
+      DebugMessageCount entry{};
+      entry.id = static_cast<int32_t>(key);
+      entry.count = m_ids[i].count.load(std::memory_order_relaxed);
+      if (const auto name = m_names.find(entry.id); name != m_names.end()) {
+        entry.name = name->second;
+      }
+      result.push_back(std::move(entry));
+    }
+  }
+  std::ranges::sort(result, [](const auto& lhs, const auto& rhs) { return lhs.count > rhs.count; });
+  return result;
+}
+
+uint64_t DebugMessageSink::dropped() const {
+  return m_dropped.load(std::memory_order_relaxed);
+}
+
+const DebugMessageFilter& DebugMessageSink::filter() const {
+  return m_filter;
+}
+
+const PerfLintReport* DebugMessageSink::perf_report() const {
+  return m_perf_report.get();
+}
+
+void DebugMessageSink::log(const VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+                           const VkDebugUtilsMessageTypeFlagsEXT type, const char* message) {
+  const std::string text = type_prefix(type) + message;
+  if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
+    VkError(text);
+  } else if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
+    VkWarning(text);
+  } else if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) {
+    VkInfo(text);
+  } else {
+    VkTrace(text);
+  }
+}
+
+uint64_t DebugMessageSink::count_id(const int32_t id) {
+  const int64_t key{id};
+  const size_t hash = static_cast<size_t>(static_cast<uint32_t>(id) * 2654435761u);
+  for (size_t i = 0; i < id_table_size; i++) {
+    auto& slot = m_ids[(hash + i) & (id_table_size - 1)];
+    int64_t current = slot.key.load(std::memory_order_acquire);
+    if (current == empty_key && slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+      current = key;
+    }
+    if (current == key) {
+      return slot.count.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+  }
+  return 0;
+}
+
+void DebugMessageSink::run() {
+  while (true) {
+    const uint32_t wake = m_wake.load(std::memory_order_acquire);
+    drain();
+    if (m_stop.load(std::memory_order_acquire)) {
+      drain();
+      return;
+    }
+    m_wake.wait(wake, std::memory_order_acquire);
+  }
+}
+
+void DebugMessageSink::drain() {
+  Message message{};
+  while (m_ring.try_pop(message)) {
+    write(message);
+    m_logged.fetch_add(1, std::memory_order_release);
+    m_logged.notify_all();
+  }
+}
+
+void DebugMessageSink::write(const Message& message) {
+  if (message.name[0] != '\0') {
+    const std::lock_guard lock{m_names_mutex};
+    m_names.try_emplace(message.id, message.name.data());
+  }
+
+  log(message.severity, message.type, message.text.data());
+  if (m_filter.log_limit_per_id > 0 && message.occurrence == m_filter.log_limit_per_id) {
+    VkInfo("Further occurrences of message id " + std::to_string(message.id) + " are counted, not logged");
+  }
+}
+
+void DebugMessageSink::summary() const {
+  for (const auto& [id, name, count] : counts()) {
+    if (m_filter.log_limit_per_id > 0 && count > m_filter.log_limit_per_id) {
+      VkInfo((name.empty() ? std::to_string(id) : name) + ": " + std::to_string(count) + " occurrences");
+    }
+  }
+  if (const auto drop_count = dropped(); drop_count > 0) {
+    VkWarning(std::to_string(drop_count) + " validation messages were dropped (ring buffer full)");
+  }
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,121 @@
+#pragma once
+#include "VkStartup/Context/PerfLintReport.h"
+#include "VkStartup/Misc/MpmcRing.h"
+#include <vulkan/vulkan_core.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace VkStartup {
+
+struct DebugMessageFilter {
+  // Messages outside these flags are not reported by the messenger at all
+  VkDebugUtilsMessageSeverityFlagsEXT severities{VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+                                                 VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT};
+  VkDebugUtilsMessageTypeFlagsEXT types{VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+                                        VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                                        VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT};
+  // Occurrences of each message id that are logged; later ones are only counted (0 = no limit)
+  uint32_t log_limit_per_id{1};
+  // Message ids (VkDebugUtilsMessengerCallbackDataEXT::messageIdNumber) that are never logged
+  std::vector<int32_t> muted_ids{};
+  // Log on a background thread.  When false, messages are logged in the callback.
+  bool async{true};
+  // Pending messages; messages arriving while the ring is full are dropped (and counted)
+  size_t ring_capacity{256};
+  // Aggregate performance messages into a 'PerfLintReport' (see 'InitContextOptions::perf_lint')
+  bool perf_report{false};
+  // JSON report written when the sink is destroyed.  Empty for no file.
+  std::filesystem::path perf_report_path{};
+};
+
+struct DebugMessageCount {
+  int32_t id{0};
+  std::string name{};
+  uint64_t count{0};
+};
+
+// Receives messenger callbacks.  The callback only filters, counts the message id and copies
+// the text into a lock-free ring; formatting and logging happen on the logger thread.  Message
+// id counts live in a fixed open addressing table of atomics, so the callback never locks.
+// Validation callbacks can come from any thread the application records or submits on.
+class DebugMessageSink {
+ public:
+  explicit DebugMessageSink(DebugMessageFilter filter);
+  ~DebugMessageSink();
+
+  DebugMessageSink(const DebugMessageSink& source) = delete;
+  DebugMessageSink& operator=(const DebugMessageSink& rhs) = delete;
+  DebugMessageSink(DebugMessageSink&& source) noexcept = delete;
+  DebugMessageSink& operator=(DebugMessageSink&& rhs) noexcept = delete;
+
+  // Called from 'VkDebugger::debug_callback'
+  void submit(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type,
+              const VkDebugUtilsMessengerCallbackDataEXT& data);
+
+  // Blocks until every queued message has been logged
+  void flush();
+
+  // Occurrences per message id, most frequent first
+  [[nodiscard]] std::vector<DebugMessageCount> counts() const;
+  [[nodiscard]] uint64_t dropped() const;
+  [[nodiscard]] const DebugMessageFilter& filter() const;
+  // Null unless 'DebugMessageFilter::perf_report' is set
+  [[nodiscard]] const PerfLintReport* perf_report() const;
+
+  // Synchronous logging (used before a sink exists, e.g. during instance creation)
+  static void log(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type,
+                  const char* message);
+
+ private:
+  struct Message {
+    VkDebugUtilsMessageSeverityFlagBitsEXT severity{VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT};
+    VkDebugUtilsMessageTypeFlagsEXT type{0};
+    int32_t id{0};
+    uint64_t occurrence{0};
+    std::array<char, 64> name{};
+    // Truncated to fit
+    std::array<char, 1024> text{};
+  };
+
+  static constexpr int64_t empty_key{std::numeric_limits<int64_t>::min()};
+  struct IdCount {
+    std::atomic<int64_t> key{empty_key};
+    std::atomic<uint64_t> count{0};
+  };
+
+  // Returns the occurrence number of the id (1 for the first).  0 if the table is full.
+  [[nodiscard]] uint64_t count_id(int32_t id);
+  void run();
+  void drain();
+  void write(const Message& message);
+  void summary() const;
+
+  DebugMessageFilter m_filter{};
+  MpmcRing<Message> m_ring;
+  static constexpr size_t id_table_size{1024};
+  std::unique_ptr<IdCount[]> m_ids{};
+  std::atomic<uint64_t> m_dropped{0};
+  std::unique_ptr<PerfLintReport> m_perf_report{};
+
+  // Pushed / logged messages; 'flush' waits for the two to match
+  std::atomic<uint64_t> m_pushed{0};
+  std::atomic<uint64_t> m_logged{0};
+  std::atomic<uint32_t> m_wake{0};
+  std::atomic<bool> m_stop{false};
+  std::thread m_logger{};
+
+  // Names are only known once a message reaches the logger
+  mutable std::mutex m_names_mutex{};
+  std::unordered_map<int32_t, std::string> m_names{};
+};
+
+}  // namespace VkStartup
@@ -2,10 +2,12 @@
 #include "VkStartup/Misc/Exceptions.h"
 #include "VkStartup/Misc/CreateInfo.h"
 #include "VkShared/Macros.h"
+#include <utility>
 
 namespace VkStartup {
 
-VkDebugger::VkDebugger(VkInstance instance) : m_vk_instance{instance} {
+VkDebugger::VkDebugger(VkInstance instance, DebugMessageFilter filter)
+    : m_vk_instance{instance}, m_sink{std::make_unique<DebugMessageSink>(std::move(filter))} {
   init();
 }
 
@@ -14,7 +16,9 @@ VkDebugger::~VkDebugger() {
 }
 
 VkDebugger::VkDebugger(VkDebugger&& source) noexcept
-    : m_vk_instance(source.m_vk_instance), m_debug_messenger{source.m_debug_messenger} {
+    : m_vk_instance(source.m_vk_instance),
+      m_debug_messenger{source.m_debug_messenger},
+      m_sink{std::move(source.m_sink)} {
   source.reset();
 }
 
@@ -23,18 +27,23 @@ VkDebugger& VkDebugger::operator=(VkDebugger&& rhs) noexcept {
     this->destroy(m_vk_instance, m_debug_messenger, nullptr);
     m_vk_instance = rhs.m_vk_instance;
     m_debug_messenger = rhs.m_debug_messenger;
+    m_sink = std::move(rhs.m_sink);
     rhs.reset();
   }
   return *this;
 }
 
-VkDebugUtilsMessengerCreateInfoEXT VkDebugger::instance_debug_create_info() {
+VkDebugUtilsMessengerCreateInfoEXT VkDebugger::instance_debug_create_info(const DebugMessageFilter& filter) {
   // Create and destroy debug info (normal debugging requires a valid instance)
-  auto create_info = CreateInfo::vk_debug_utils_messenger_create_info();
+  auto create_info = CreateInfo::vk_debug_utils_messenger_create_info(filter.severities, filter.types);
   create_info.pfnUserCallback = debug_callback;
   return create_info;
 }
 
+DebugMessageSink& VkDebugger::sink() const {
+  return *m_sink;
+}
+
 void VkDebugger::reset() {
   m_vk_instance = VK_NULL_HANDLE;
   m_debug_messenger = VK_NULL_HANDLE;
@@ -45,13 +54,18 @@ VKAPI_ATTR VkBool32 VKAPI_CALL VkDebugger::debug_callback(
     [[maybe_unused]] VkDebugUtilsMessageSeverityFlagBitsEXT severity,
     [[maybe_unused]] VkDebugUtilsMessageTypeFlagsEXT type, const VkDebugUtilsMessengerCallbackDataEXT* callback_data,
     [[maybe_unused]] void* user_data) {
-  VkError(callback_data->pMessage);
+  if (user_data) {
+    static_cast<DebugMessageSink*>(user_data)->submit(severity, type, *callback_data);
+  } else {
+    DebugMessageSink::log(severity, type, callback_data->pMessage);
+  }
   return VK_FALSE;
 }
 #pragma warning(default : 4100)
 
 void VkDebugger::init() {
-  auto create_info = CreateInfo::vk_debug_utils_messenger_create_info();
+  const auto& filter = m_sink->filter();
+  auto create_info = CreateInfo::vk_debug_utils_messenger_create_info(filter.severities, filter.types, m_sink.get());
   create_info.pfnUserCallback = debug_callback;
 
   VkCheck(create_debug_messenger_ext(m_vk_instance, &create_info, nullptr, &m_debug_messenger),
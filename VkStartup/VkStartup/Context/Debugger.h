@@ -1,11 +1,13 @@
 #pragma once
+#include "VkStartup/Context/DebugMessageSink.h"
 #include <vulkan/vulkan_core.h>
+#include <memory>
 
 namespace VkStartup {
 
 class VkDebugger {
  public:
-  explicit VkDebugger(VkInstance instance);
+  explicit VkDebugger(VkInstance instance, DebugMessageFilter filter = {});
   ~VkDebugger();
 
   VkDebugger(VkDebugger&& source) noexcept;
@@ -13,7 +15,12 @@ class VkDebugger {
   VkDebugger(const VkDebugger& source) = delete;
   VkDebugger& operator=(const VkDebugger& rhs) = delete;
 
-  [[nodiscard]] static VkDebugUtilsMessengerCreateInfoEXT instance_debug_create_info();
+  // Messages during instance creation & destruction are logged synchronously
+  [[nodiscard]] static VkDebugUtilsMessengerCreateInfoEXT instance_debug_create_info(
+      const DebugMessageFilter& filter = {});
+
+  // Filtered, deduplicated messages of the messenger (see 'DebugMessageSink')
+  [[nodiscard]] DebugMessageSink& sink() const;
 
  private:
   void reset();
@@ -30,6 +37,8 @@ class VkDebugger {
 
   VkInstance m_vk_instance = VK_NULL_HANDLE;
   VkDebugUtilsMessengerEXT m_debug_messenger = VK_NULL_HANDLE;
+  // Heap allocated so the messenger's user data survives moves
+  std::unique_ptr<DebugMessageSink> m_sink{};
 };
 
 }  // namespace VkStartup
@@ -0,0 +1,374 @@
+#include "VkStartup/Context/FeatureChain.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+namespace VkStartup {
+
+namespace {
+
+// VkBool32 members of each feature struct.  Listed explicitly: structs with an odd number of
+// members have trailing padding, so the struct can't be treated as a VkBool32 array.
+template <typename T>
+struct FeatureMembers;
+
+template <>
+struct FeatureMembers<VkPhysicalDeviceFeatures> {
+  static constexpr std::array members{
+      &VkPhysicalDeviceFeatures::robustBufferAccess, &VkPhysicalDeviceFeatures::fullDrawIndexUint32,
+      &VkPhysicalDeviceFeatures::imageCubeArray, &VkPhysicalDeviceFeatures::independentBlend,
+      &VkPhysicalDeviceFeatures::geometryShader, &VkPhysicalDeviceFeatures::tessellationShader,
+      &VkPhysicalDeviceFeatures::sampleRateShading, &VkPhysicalDeviceFeatures::dualSrcBlend,
+      &VkPhysicalDeviceFeatures::logicOp, &VkPhysicalDeviceFeatures::multiDrawIndirect,
+      &VkPhysicalDeviceFeatures::drawIndirectFirstInstance, &VkPhysicalDeviceFeatures::depthClamp,
+      &VkPhysicalDeviceFeatures::depthBiasClamp, &VkPhysicalDeviceFeatures::fillModeNonSolid,
+      &VkPhysicalDeviceFeatures::depthBounds, &VkPhysicalDeviceFeatures::wideLines,
+      &VkPhysicalDeviceFeatures::largePoints, &VkPhysicalDeviceFeatures::alphaToOne,
+      &VkPhysicalDeviceFeatures::multiViewport, &VkPhysicalDeviceFeatures::samplerAnisotropy,
+      &VkPhysicalDeviceFeatures::textureCompressionETC2, &VkPhysicalDeviceFeatures::textureCompressionASTC_LDR,
+      &VkPhysicalDeviceFeatures::textureCompressionBC, &VkPhysicalDeviceFeatures::occlusionQueryPrecise,
+      &VkPhysicalDeviceFeatures::pipelineStatisticsQuery, &VkPhysicalDeviceFeatures::vertexPipelineStoresAndAtomics,
+      &VkPhysicalDeviceFeatures::fragmentStoresAndAtomics,
+      &VkPhysicalDeviceFeatures::shaderTessellationAndGeometryPointSize,
+      &VkPhysicalDeviceFeatures::shaderImageGatherExtended,
+      &VkPhysicalDeviceFeatures::shaderStorageImageExtendedFormats,
+      &VkPhysicalDeviceFeatures::shaderStorageImageMultisample,
+      &VkPhysicalDeviceFeatures::shaderStorageImageReadWithoutFormat,
+      &VkPhysicalDeviceFeatures::shaderStorageImageWriteWithoutFormat,
+      &VkPhysicalDeviceFeatures::shaderUniformBufferArrayDynamicIndexing,
+      &VkPhysicalDeviceFeatures::shaderSampledImageArrayDynamicIndexing,
+      &VkPhysicalDeviceFeatures::shaderStorageBufferArrayDynamicIndexing,
+      &VkPhysicalDeviceFeatures::shaderStorageImageArrayDynamicIndexing,
+      &VkPhysicalDeviceFeatures::shaderClipDistance, &VkPhysicalDeviceFeatures::shaderCullDistance,
+      &VkPhysicalDeviceFeatures::shaderFloat64, &VkPhysicalDeviceFeatures::shaderInt64,
+      &VkPhysicalDeviceFeatures::shaderInt16, &VkPhysicalDeviceFeatures::shaderResourceResidency,
+      &VkPhysicalDeviceFeatures::shaderResourceMinLod, &VkPhysicalDeviceFeatures::sparseBinding,
+      &VkPhysicalDeviceFeatures::sparseResidencyBuffer, &VkPhysicalDeviceFeatures::sparseResidencyImage2D,
+      &VkPhysicalDeviceFeatures::sparseResidencyImage3D, &VkPhysicalDeviceFeatures::sparseResidency2Samples,
+      &VkPhysicalDeviceFeatures::sparseResidency4Samples, &VkPhysicalDeviceFeatures::sparseResidency8Samples,
+      &VkPhysicalDeviceFeatures::sparseResidency16Samples, &VkPhysicalDeviceFeatures::sparseResidencyAliased,
+      &VkPhysicalDeviceFeatures::variableMultisampleRate, &VkPhysicalDeviceFeatures::inheritedQueries};
+};
+
+template <>
+struct FeatureMembers<VkPhysicalDeviceTimelineSemaphoreFeatures> {
+  static constexpr std::array members{&VkPhysicalDeviceTimelineSemaphoreFeatures::timelineSemaphore};
+};
+
+template <>
+struct FeatureMembers<VkPhysicalDeviceSynchronization2Features> {
+  static constexpr std::array members{&VkPhysicalDeviceSynchronization2Features::synchronization2};
+};
+
+template <>
+struct FeatureMembers<VkPhysicalDeviceBufferDeviceAddressFeatures> {
+  static constexpr std::array members{
+      &VkPhysicalDeviceBufferDeviceAddressFeatures::bufferDeviceAddress,
+      &VkPhysicalDeviceBufferDeviceAddressFeatures::bufferDeviceAddressCaptureReplay,
+      &VkPhysicalDeviceBufferDeviceAddressFeatures::bufferDeviceAddressMultiDevice};
+};
+
+template <>
+struct FeatureMembers<VkPhysicalDeviceDescriptorIndexingFeatures> {
+  static constexpr std::array members{
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderInputAttachmentArrayDynamicIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderUniformTexelBufferArrayDynamicIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderStorageTexelBufferArrayDynamicIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderUniformBufferArrayNonUniformIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderSampledImageArrayNonUniformIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderStorageBufferArrayNonUniformIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderStorageImageArrayNonUniformIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderInputAttachmentArrayNonUniformIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderUniformTexelBufferArrayNonUniformIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::shaderStorageTexelBufferArrayNonUniformIndexing,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingUniformBufferUpdateAfterBind,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingSampledImageUpdateAfterBind,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingStorageImageUpdateAfterBind,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingStorageBufferUpdateAfterBind,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingUniformTexelBufferUpdateAfterBind,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingStorageTexelBufferUpdateAfterBind,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingUpdateUnusedWhilePending,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingPartiallyBound,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::descriptorBindingVariableDescriptorCount,
+      &VkPhysicalDeviceDescriptorIndexingFeatures::runtimeDescriptorArray};
+};
+
+template <>
+struct FeatureMembers<VkPhysicalDeviceDynamicRenderingFeatures> {
+  static constexpr std::array members{&VkPhysicalDeviceDynamicRenderingFeatures::dynamicRendering};
+};
+
+template <>
+struct FeatureMembers<VkPhysicalDeviceMemoryPriorityFeaturesEXT> {
+  static constexpr std::array members{&VkPhysicalDeviceMemoryPriorityFeaturesEXT::memoryPriority};
+};
+
+template <>
+struct FeatureMembers<VkPhysicalDeviceCoherentMemoryFeaturesAMD> {
+  static constexpr std::array members{&VkPhysicalDeviceCoherentMemoryFeaturesAMD::deviceCoherentMemory};
+};
+
+// Catches a member missing from the list above (VkPhysicalDeviceFeatures has no padding)
+static_assert(FeatureMembers<VkPhysicalDeviceFeatures>::members.size() * sizeof(VkBool32) ==
+              sizeof(VkPhysicalDeviceFeatures));
+
+// Calls 'fn' with each pair of matching feature structs
+template <typename Chain, typename Fn>
+void for_each_struct(Chain& chain, const FeatureChain& other, Fn fn) {
+  fn(chain.features2.features, other.features2.features);
+  fn(chain.timeline_semaphore, other.timeline_semaphore);
+  fn(chain.synchronization2, other.synchronization2);
+  fn(chain.buffer_device_address, other.buffer_device_address);
+  fn(chain.descriptor_indexing, other.descriptor_indexing);
+  fn(chain.dynamic_rendering, other.dynamic_rendering);
+  fn(chain.memory_priority, other.memory_priority);
+  fn(chain.device_coherent_memory, other.device_coherent_memory);
+}
+
+template <typename T>
+bool any_requested(const T& features) {
+  return std::ranges::any_of(FeatureMembers<T>::members,
+                             [&features](const auto member) { return features.*member == VK_TRUE; });
+}
+
+template <typename T>
+bool satisfied(const T& requested, const T& supported) {
+  return std::ranges::none_of(FeatureMembers<T>::members, [&requested, &supported](const auto member) {
+    return requested.*member == VK_TRUE && supported.*member != VK_TRUE;
+  });
+}
+
+bool has_ext(const std::vector<const char*>& extensions, const char* name) {
+  return std::ranges::any_of(extensions, [name](const char* ext) { return std::string_view{ext} == name; });
+}
+
+// Core version of each struct and the extension exposing it on earlier versions
+struct ChainEntry {
+  uint32_t core_version{0};
+  uint32_t ext_min_version{0};
+  const char* ext_name{nullptr};
+};
+
+constexpr ChainEntry timeline_entry{VK_API_VERSION_1_2, VK_API_VERSION_1_1, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME};
+constexpr ChainEntry sync2_entry{VK_API_VERSION_1_3, VK_API_VERSION_1_1, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME};
+constexpr ChainEntry bda_entry{VK_API_VERSION_1_2, VK_API_VERSION_1_1, VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME};
+constexpr ChainEntry indexing_entry{VK_API_VERSION_1_2, VK_API_VERSION_1_1, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME};
+// The dynamic rendering extension depends on extensions that are core in 1.2
+constexpr ChainEntry dynamic_entry{VK_API_VERSION_1_3, VK_API_VERSION_1_2, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME};
+// Never core
+constexpr uint32_t not_core{std::numeric_limits<uint32_t>::max()};
+constexpr ChainEntry priority_entry{not_core, VK_API_VERSION_1_1, VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME};
+constexpr ChainEntry coherent_entry{not_core, VK_API_VERSION_1_1, VK_AMD_DEVICE_COHERENT_MEMORY_EXTENSION_NAME};
+
+bool chainable(const ChainEntry& entry, const uint32_t api_version, const std::vector<const char*>& extensions) {
+  return api_version >= entry.core_version ||
+         (api_version >= entry.ext_min_version && has_ext(extensions, entry.ext_name));
+}
+
+}  // namespace
+
+FeatureChain::FeatureChain() {
+  features2 = CreateInfo::vk_physical_device_features2();
+  timeline_semaphore.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+  synchronization2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+  buffer_device_address.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
+  descriptor_indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+  dynamic_rendering = CreateInfo::vk_physical_device_dynamic_rendering_features();
+  memory_priority.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+  device_coherent_memory.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COHERENT_MEMORY_FEATURES_AMD;
+}
+
+FeatureChain::FeatureChain(const FeatureChain& source)
+    : features2{source.features2},
+      timeline_semaphore{source.timeline_semaphore},
+      synchronization2{source.synchronization2},
+      buffer_device_address{source.buffer_device_address},
+      descriptor_indexing{source.descriptor_indexing},
+      dynamic_rendering{source.dynamic_rendering},
+      memory_priority{source.memory_priority},
+      device_coherent_memory{source.device_coherent_memory} {
+  unlink();
+}
+
+FeatureChain& FeatureChain::operator=(const FeatureChain& rhs) {
+  if (this != &rhs) {
+    features2 = rhs.features2;
+    timeline_semaphore = rhs.timeline_semaphore;
+    synchronization2 = rhs.synchronization2;
+    buffer_device_address = rhs.buffer_device_address;
+    descriptor_indexing = rhs.descriptor_indexing;
+    dynamic_rendering = rhs.dynamic_rendering;
+    memory_priority = rhs.memory_priority;
+    device_coherent_memory = rhs.device_coherent_memory;
+    unlink();
+  }
+  return *this;
+}
+
+FeatureChain::FeatureChain(FeatureChain&& source) noexcept : FeatureChain{static_cast<const FeatureChain&>(source)} {
+}
+
+FeatureChain& FeatureChain::operator=(FeatureChain&& rhs) noexcept {
+  return *this = static_cast<const FeatureChain&>(rhs);
+}
+
+void FeatureChain::unlink() {
+  features2.pNext = nullptr;
+  timeline_semaphore.pNext = nullptr;
+  synchronization2.pNext = nullptr;
+  buffer_device_address.pNext = nullptr;
+  descriptor_indexing.pNext = nullptr;
+  dynamic_rendering.pNext = nullptr;
+  memory_priority.pNext = nullptr;
+  device_coherent_memory.pNext = nullptr;
+}
+
+VkPhysicalDeviceFeatures2* FeatureChain::link(const uint32_t api_version,
+                                              const std::vector<const char*>& extensions) {
+  unlink();
+  void** next = &features2.pNext;
+  const auto append = [&next](auto& features) {
+    *next = &features;
+    next = &features.pNext;
+  };
+
+  if (chainable(timeline_entry, api_version, extensions)) {
+    append(timeline_semaphore);
+  }
+  if (chainable(sync2_entry, api_version, extensions)) {
+    append(synchronization2);
+  }
+  if (chainable(bda_entry, api_version, extensions)) {
+    append(buffer_device_address);
+  }
+  if (chainable(indexing_entry, api_version, extensions)) {
+    append(descriptor_indexing);
+  }
+  if (chainable(dynamic_entry, api_version, extensions)) {
+    append(dynamic_rendering);
+  }
+  if (chainable(priority_entry, api_version, extensions)) {
+    append(memory_priority);
+  }
+  if (chainable(coherent_entry, api_version, extensions)) {
+    append(device_coherent_memory);
+  }
+  return &features2;
+}
+
+FeatureChain FeatureChain::available(const uint32_t api_version, const std::vector<const char*>& extensions) const {
+  FeatureChain chain{*this};
+  const auto clear = [api_version, &extensions](const ChainEntry& entry, auto& features) {
+    if (!chainable(entry, api_version, extensions)) {
+      const auto type = features.sType;
+      features = {};
+      features.sType = type;
+    }
+  };
+  clear(timeline_entry, chain.timeline_semaphore);
+  clear(sync2_entry, chain.synchronization2);
+  clear(bda_entry, chain.buffer_device_address);
+  clear(indexing_entry, chain.descriptor_indexing);
+  clear(dynamic_entry, chain.dynamic_rendering);
+  clear(priority_entry, chain.memory_priority);
+  clear(coherent_entry, chain.device_coherent_memory);
+  return chain;
+}
+
+std::vector<const char*> FeatureChain::required_extensions(const uint32_t api_version) const {
+  std::vector<const char*> extensions{};
+  const auto add = [&extensions, api_version](const ChainEntry& entry, const auto& features) {
+    if (api_version < entry.core_version && any_requested(features)) {
+      extensions.push_back(entry.ext_name);
+    }
+  };
+  add(timeline_entry, timeline_semaphore);
+  add(sync2_entry, synchronization2);
+  add(bda_entry, buffer_device_address);
+  add(indexing_entry, descriptor_indexing);
+  add(dynamic_entry, dynamic_rendering);
+  add(priority_entry, memory_priority);
+  add(coherent_entry, device_coherent_memory);
+  return extensions;
+}
+
+std::vector<std::string> FeatureChain::unsupported(const FeatureChain& supported) const {
+  std::vector<std::string> names{};
+  const auto check = [&names](const std::string& name, const auto& requested, const auto& available) {
+    if (!satisfied(requested, available)) {
+      names.push_back(name);
+    }
+  };
+  check("VkPhysicalDeviceFeatures", features2.features, supported.features2.features);
+  check("VkPhysicalDeviceTimelineSemaphoreFeatures", timeline_semaphore, supported.timeline_semaphore);
+  check("VkPhysicalDeviceSynchronization2Features", synchronization2, supported.synchronization2);
+  check("VkPhysicalDeviceBufferDeviceAddressFeatures", buffer_device_address, supported.buffer_device_address);
+  check("VkPhysicalDeviceDescriptorIndexingFeatures", descriptor_indexing, supported.descriptor_indexing);
+  check("VkPhysicalDeviceDynamicRenderingFeatures", dynamic_rendering, supported.dynamic_rendering);
+  check("VkPhysicalDeviceMemoryPriorityFeaturesEXT", memory_priority, supported.memory_priority);
+  check("VkPhysicalDeviceCoherentMemoryFeaturesAMD", device_coherent_memory, supported.device_coherent_memory);
+  return names;
+}
+
+void FeatureChain::merge(const FeatureChain& other) {
+  for_each_struct(*this, other, [](auto& features, const auto& other_features) {
+    for (const auto member : FeatureMembers<std::remove_cvref_t<decltype(features)>>::members) {
+      features.*member = features.*member == VK_TRUE || other_features.*member == VK_TRUE ? VK_TRUE : VK_FALSE;
+    }
+  });
+}
+
+FeatureChain FeatureChain::intersect(const FeatureChain& supported) const {
+  FeatureChain chain{*this};
+  for_each_struct(chain, supported, [](auto& features, const auto& supported_features) {
+    for (const auto member : FeatureMembers<std::remove_cvref_t<decltype(features)>>::members) {
+      features.*member = features.*member == VK_TRUE && supported_features.*member == VK_TRUE ? VK_TRUE : VK_FALSE;
+    }
+  });
+  return chain;
+}
+
+uint32_t FeatureChain::count() const {
+  uint32_t total{0};
+  for_each_struct(*this, *this, [&total](const auto& features, const auto&) {
+    total += static_cast<uint32_t>(std::ranges::count_if(
+        FeatureMembers<std::remove_cvref_t<decltype(features)>>::members,
+        [&features](const auto member) { return features.*member == VK_TRUE; }));
+  });
+  return total;
+}
+
+FeatureChain FeatureChain::query(VkInstance instance, VkPhysicalDevice device, const uint32_t api_version) {
+  FeatureChain supported{};
+
+  // Core in 1.1; otherwise requires VK_KHR_get_physical_device_properties2 on the instance
+  auto get_features2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2>(
+      vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2"));
+  if (!get_features2) {
+    get_features2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR"));
+  }
+  if (!get_features2 || api_version < VK_API_VERSION_1_1) {
+    vkGetPhysicalDeviceFeatures(device, &supported.features2.features);
+    return supported;
+  }
+
+  uint32_t extension_count{0};
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+  std::vector<VkExtensionProperties> properties{extension_count};
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, properties.data());
+  std::vector<const char*> extensions{};
+  extensions.reserve(properties.size());
+  for (const auto& property : properties) {
+    extensions.push_back(property.extensionName);
+  }
+
+  get_features2(device, supported.link(api_version, extensions));
+  supported.unlink();
+  return supported;
+}
+
+}  // namespace VkStartup
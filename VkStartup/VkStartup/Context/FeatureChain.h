@@ -0,0 +1,63 @@
+#pragma once
+#include <vulkan/vulkan_core.h>
+#include <string>
+#include <vector>
+
+namespace VkStartup {
+
+// VkPhysicalDeviceFeatures2 pNext chain.  Individual feature structs are used (rather than
+// VkPhysicalDeviceVulkan1xFeatures) so the chain also works through extensions on older api
+// versions.  A struct is only chained when it is core in the api version or its extension is
+// in the extension list.  Extended features require an api version of at least 1.1.
+//
+// Copies don't share pointers; 'link' must be called before the chain is passed to Vulkan.
+struct FeatureChain {
+  FeatureChain();
+  ~FeatureChain() = default;
+
+  FeatureChain(const FeatureChain& source);
+  FeatureChain& operator=(const FeatureChain& rhs);
+  FeatureChain(FeatureChain&& source) noexcept;
+  FeatureChain& operator=(FeatureChain&& rhs) noexcept;
+
+  // Chain the structs available for 'api_version' & 'extensions'.  Returns the chain head.
+  VkPhysicalDeviceFeatures2* link(uint32_t api_version, const std::vector<const char*>& extensions);
+
+  // Copy with the structs that can't be chained for 'api_version' & 'extensions' cleared
+  [[nodiscard]] FeatureChain available(uint32_t api_version, const std::vector<const char*>& extensions) const;
+
+  // Extensions needed to chain every struct with a requested feature at 'api_version'
+  [[nodiscard]] std::vector<const char*> required_extensions(uint32_t api_version) const;
+
+  // Names of the structs containing requested features that 'supported' does not report
+  [[nodiscard]] std::vector<std::string> unsupported(const FeatureChain& supported) const;
+
+  // Requests the features requested in 'other' as well
+  void merge(const FeatureChain& other);
+
+  // Copy with the features 'supported' does not report cleared
+  [[nodiscard]] FeatureChain intersect(const FeatureChain& supported) const;
+
+  // Number of requested features across every struct
+  [[nodiscard]] uint32_t count() const;
+
+  // Supported features of the device.  Structs are chained for every extension the device
+  // supports (enabled or not).
+  [[nodiscard]] static FeatureChain query(VkInstance instance, VkPhysicalDevice device, uint32_t api_version);
+
+  // 'features2.features' replaces 'VkDeviceCreateInfo::pEnabledFeatures' when chained
+  VkPhysicalDeviceFeatures2 features2 = {};
+  VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore = {};
+  VkPhysicalDeviceSynchronization2Features synchronization2 = {};
+  VkPhysicalDeviceBufferDeviceAddressFeatures buffer_device_address = {};
+  VkPhysicalDeviceDescriptorIndexingFeatures descriptor_indexing = {};
+  VkPhysicalDeviceDynamicRenderingFeatures dynamic_rendering = {};
+  // Extension only (VK_EXT_memory_priority, VK_AMD_device_coherent_memory)
+  VkPhysicalDeviceMemoryPriorityFeaturesEXT memory_priority = {};
+  VkPhysicalDeviceCoherentMemoryFeaturesAMD device_coherent_memory = {};
+
+ private:
+  void unlink();
+};
+
+}  // namespace VkStartup
@@ -0,0 +1,38 @@
+#pragma once
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <vector>
+
+namespace VkStartup {
+
+// Synchronization owned by a single frame in flight
+struct FrameSync {
+  VkSemaphoreHandle image_available{};
+  VkFenceHandle in_flight{};
+};
+
+// Ring of frames in flight for a single surface
+struct FrameRing {
+  std::vector<FrameSync> frames{};
+
+  // One per swapchain image.  The presentation engine may still be waiting on a
+  // semaphore after the frame fence signals, so these can't be reused per frame.
+  std::vector<VkSemaphoreHandle> render_finished{};
+
+  // Fence of the frame that last rendered to each swapchain image (not owned)
+  std::vector<VkFence> images_in_flight{};
+
+  uint32_t frame_index{0};
+  uint32_t image_index{0};
+};
+
+// Handles for the frame returned from 'begin_frame'
+struct FrameInfo {
+  uint32_t frame_index{0};
+  uint32_t image_index{0};
+  VkSemaphore image_available{VK_NULL_HANDLE};
+  VkSemaphore render_finished{VK_NULL_HANDLE};
+  VkFence in_flight{VK_NULL_HANDLE};
+};
+
+}  // namespace VkStartup
@@ -0,0 +1,104 @@
+#include "VkStartup/Context/FramebufferCache.h"
+#include "VkStartup/Context/Context.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include <functional>
+
+namespace VkStartup {
+
+FramebufferCache::FramebufferCache(VkDevice device) : m_vk_device{device} {
+}
+
+VkFramebuffer FramebufferCache::get(const std::string& owner_id, VkRenderPass renderpass,
+                                    const std::vector<VkImageView>& attachments, const VkExtent2D extent,
+                                    const uint32_t layers) {
+  Key key{renderpass, attachments, extent.width, extent.height, layers};
+
+  std::lock_guard lock{m_mutex};
+  if (const auto itr = m_framebuffers.find(key); itr != m_framebuffers.end()) {
+    return itr->second.framebuffer();
+  }
+
+  auto info = CreateInfo::vk_framebuffer_create_info(extent.width, extent.height);
+  info.renderPass = renderpass;
+  info.attachmentCount = static_cast<uint32_t>(attachments.size());
+  info.pAttachments = attachments.data();
+  info.layers = layers;
+
+  const auto [itr, inserted] =
+      m_framebuffers.emplace(std::move(key), Entry{owner_id, VkFramebufferHandle{info, m_vk_device}});
+  return itr->second.framebuffer();
+}
+
+const std::vector<VkFramebuffer>& FramebufferCache::swapchain_framebuffers(
+    const std::string& id, VkSwapchainContext& swap_ctx, VkRenderPass renderpass,
+    const std::vector<VkImageView>& extra_attachments) {
+  auto& rp_buffers = swap_ctx.rp_buffers;
+  const auto& depth_views = swap_ctx.offscreen.depth_views;
+  const VkExtent2D extent{rp_buffers.width, rp_buffers.height};
+
+  rp_buffers.framebuffers.clear();
+  std::vector<VkImageView> attachments{};
+  for (size_t i = 0; i < rp_buffers.image_views.size(); i++) {
+    attachments.clear();
+    attachments.push_back(rp_buffers.image_views[i]());
+    if (i < depth_views.size()) {
+      attachments.push_back(depth_views[i]());
+    }
+    attachments.insert(attachments.end(), extra_attachments.begin(), extra_attachments.end());
+    rp_buffers.framebuffers.push_back(get(id, renderpass, attachments, extent));
+  }
+  return rp_buffers.framebuffers;
+}
+
+std::vector<VkFramebufferHandle> FramebufferCache::invalidate(const std::string& owner_id) {
+  std::vector<VkFramebufferHandle> removed{};
+  std::lock_guard lock{m_mutex};
+  for (auto itr = m_framebuffers.begin(); itr != m_framebuffers.end();) {
+    if (itr->second.owner_id == owner_id) {
+      removed.push_back(std::move(itr->second.framebuffer));
+      itr = m_framebuffers.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+  return removed;
+}
+
+std::vector<VkFramebufferHandle> FramebufferCache::invalidate(VkRenderPass renderpass) {
+  std::vector<VkFramebufferHandle> removed{};
+  std::lock_guard lock{m_mutex};
+  for (auto itr = m_framebuffers.begin(); itr != m_framebuffers.end();) {
+    if (itr->first.renderpass == renderpass) {
+      removed.push_back(std::move(itr->second.framebuffer));
+      itr = m_framebuffers.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+  return removed;
+}
+
+void FramebufferCache::clear() {
+  std::lock_guard lock{m_mutex};
+  m_framebuffers.clear();
+}
+
+size_t FramebufferCache::size() const {
+  std::lock_guard lock{m_mutex};
+  return m_framebuffers.size();
+}
+
+size_t FramebufferCache::KeyHash::operator()(const Key& key) const noexcept {
+  // boost::hash_combine
+  size_t hash{std::hash<VkRenderPass>{}(key.renderpass)};
+  const auto combine = [&hash](const size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+  for (const auto view : key.attachments) {
+    combine(std::hash<VkImageView>{}(view));
+  }
+  combine(key.width);
+  combine(key.height);
+  combine(key.layers);
+  return hash;
+}
+
+}  // namespace VkStartup
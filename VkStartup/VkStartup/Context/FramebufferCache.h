@@ -0,0 +1,69 @@
+#pragma once
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VkStartup {
+
+struct VkSwapchainContext;
+
+// Framebuffers keyed by (renderpass, attachment views, extent, layers).  Each entry belongs to
+// an owner id (normally the surface / offscreen target id) so a swapchain remake only
+// invalidates the framebuffers built from that surface's views.  Views are compared by
+// handle, so entries must be invalidated before their views are destroyed; otherwise a
+// recycled handle could match a stale framebuffer.
+class FramebufferCache {
+ public:
+  explicit FramebufferCache(VkDevice device);
+
+  FramebufferCache(const FramebufferCache& source) = delete;
+  FramebufferCache& operator=(const FramebufferCache& rhs) = delete;
+  FramebufferCache(FramebufferCache&& source) noexcept = delete;
+  FramebufferCache& operator=(FramebufferCache&& rhs) noexcept = delete;
+
+  // Thread safe.  Creates the framebuffer on first use.
+  [[nodiscard]] VkFramebuffer get(const std::string& owner_id, VkRenderPass renderpass,
+                                  const std::vector<VkImageView>& attachments, VkExtent2D extent,
+                                  uint32_t layers = 1);
+
+  // One framebuffer per swapchain image: [image view, depth view (offscreen targets with depth),
+  // extra attachments...].  The result is also stored in 'swap_ctx.rp_buffers.framebuffers'.
+  const std::vector<VkFramebuffer>& swapchain_framebuffers(const std::string& id, VkSwapchainContext& swap_ctx,
+                                                           VkRenderPass renderpass,
+                                                           const std::vector<VkImageView>& extra_attachments = {});
+
+  // Removes every framebuffer owned by 'owner_id'.  The handles are returned so they can be
+  // retired through the deletion queue; discarding them destroys the framebuffers immediately.
+  std::vector<VkFramebufferHandle> invalidate(const std::string& owner_id);
+  // Removes every framebuffer built from 'renderpass' (e.g. before it is destroyed)
+  std::vector<VkFramebufferHandle> invalidate(VkRenderPass renderpass);
+  void clear();
+
+  [[nodiscard]] size_t size() const;
+
+ private:
+  struct Key {
+    VkRenderPass renderpass{VK_NULL_HANDLE};
+    std::vector<VkImageView> attachments{};
+    uint32_t width{0};
+    uint32_t height{0};
+    uint32_t layers{1};
+    bool operator==(const Key& rhs) const = default;
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const noexcept;
+  };
+  struct Entry {
+    std::string owner_id{};
+    VkFramebufferHandle framebuffer{};
+  };
+
+  VkDevice m_vk_device{VK_NULL_HANDLE};
+  mutable std::mutex m_mutex{};
+  std::unordered_map<Key, Entry, KeyHash> m_framebuffers{};
+};
+
+}  // namespace VkStartup
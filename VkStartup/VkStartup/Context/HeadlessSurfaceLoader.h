@@ -0,0 +1,129 @@
+#pragma once
+#include "VkStartup/Context/SurfaceLoader.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkShared/Macros.h"
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace VkStartup {
+
+// Surface loader backed by VK_EXT_headless_surface.  No window or display is required, so
+// the swapchain path can run on CI machines (e.g. lavapipe).  The instance must be created
+// with the extensions returned by 'extensions()'.
+class HeadlessSurfaceLoader final : public SurfaceLoader {
+ public:
+  explicit HeadlessSurfaceLoader(std::string id, const VkExtent2D extent,
+                                 std::vector<VkSurfaceFormatKHR> preferred_formats = default_formats(),
+                                 std::vector<VkPresentModeKHR> preferred_present_modes = default_present_modes())
+      : SurfaceLoader{std::move(id)},
+        m_extent{extent},
+        m_preferred_formats{std::move(preferred_formats)},
+        m_preferred_present_modes{std::move(preferred_present_modes)} {
+  }
+
+  [[nodiscard]] static std::vector<const char*> extensions() {
+    return {VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME};
+  }
+
+  // Headless surfaces have no window to resize.  Set a new extent and remake the
+  // swapchain to simulate a resize.
+  void extent(const VkExtent2D extent) {
+    m_extent = extent;
+  }
+
+  [[nodiscard]] VkExtent2D extent() const {
+    return m_extent;
+  }
+
+  // Formats are chosen in order of preference; the first supported format is used
+  [[nodiscard]] Swapchain::SwapchainFormatDetails select_swapchain_format(
+      const Swapchain::SwapchainFormatSupport& supported_details) const override {
+    Swapchain::SwapchainFormatDetails details{};
+    auto& [capabilities, formats, present_modes] = supported_details;
+
+    // Format
+    if (formats.empty()) {
+      VkError("Headless surface: " + id() + " does not report any formats");
+      throw Exceptions::VkStartupException();
+    }
+    details.format = formats.front();
+    const auto format_itr = std::ranges::find_if(m_preferred_formats, [&formats](const auto& preferred) {
+      return std::ranges::any_of(formats, [&preferred](const auto& format) {
+        return format.format == preferred.format && format.colorSpace == preferred.colorSpace;
+      });
+    });
+    if (format_itr != m_preferred_formats.end()) {
+      details.format = *format_itr;
+    } else {
+      VkWarning("Preferred headless swapchain format not found.  Defaulting to first supported format and colorspace");
+    }
+
+    // Present mode (FIFO is always supported)
+    details.present_mode = VK_PRESENT_MODE_FIFO_KHR;
+    const auto mode_itr = std::ranges::find_if(m_preferred_present_modes, [&present_modes](const auto& preferred) {
+      return std::ranges::find(present_modes, preferred) != present_modes.end();
+    });
+    if (mode_itr != m_preferred_present_modes.end()) {
+      details.present_mode = *mode_itr;
+    }
+
+    // Extent.  Headless surfaces normally leave the extent to the swapchain (0xFFFFFFFF).
+    if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
+      details.extent = capabilities.currentExtent;
+    } else {
+      details.extent.width = std::clamp(m_extent.width, capabilities.minImageExtent.width,
+                                        capabilities.maxImageExtent.width);
+      details.extent.height = std::clamp(m_extent.height, capabilities.minImageExtent.height,
+                                         capabilities.maxImageExtent.height);
+    }
+
+    // Image count
+    details.image_count = capabilities.minImageCount + 1;
+    if (capabilities.maxImageCount > 0 && details.image_count > capabilities.maxImageCount) {
+      details.image_count = capabilities.maxImageCount;
+    }
+
+    // Pre-Transform
+    details.pretransform = capabilities.currentTransform;
+
+    // Usage.  Transfer source allows presented images to be read back in automation.
+    details.usage_flags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+      details.usage_flags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+    return details;
+  }
+
+  [[nodiscard]] static std::vector<VkSurfaceFormatKHR> default_formats() {
+    return {{VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+            {VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+            {VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR}};
+  }
+
+  [[nodiscard]] static std::vector<VkPresentModeKHR> default_present_modes() {
+    // Benchmarks shouldn't be throttled by a virtual vblank
+    return {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR};
+  }
+
+ protected:
+  [[nodiscard]] VkResult init_surface() override {
+    const auto create_surface = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+        vkGetInstanceProcAddr(m_vk_instance, "vkCreateHeadlessSurfaceEXT"));
+    if (!create_surface) {
+      VkError("vkCreateHeadlessSurfaceEXT not found.  Enable " + std::string{VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME});
+      return VK_ERROR_EXTENSION_NOT_PRESENT;
+    }
+    const auto info = CreateInfo::vk_headless_surface_create_info();
+    return create_surface(m_vk_instance, &info, nullptr, &khr_surface);
+  }
+
+ private:
+  VkExtent2D m_extent = {};
+  std::vector<VkSurfaceFormatKHR> m_preferred_formats{};
+  std::vector<VkPresentModeKHR> m_preferred_present_modes{};
+};
+
+}  // namespace VkStartup
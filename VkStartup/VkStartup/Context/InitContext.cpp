@@ -2,6 +2,7 @@
 #include "VkStartup/Handle/UsingHandle.h"
 #include "VkStartup/Misc/Exceptions.h"
 #include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Profiler.h"
 #include "VkShared/Macros.h"
 #include <memory>
 #include <unordered_set>
@@ -10,6 +11,9 @@
 #include <algorithm>
 #include <type_traits>
 #include <ranges>
+#include <map>
+#include <string>
+#include <string_view>
 
 namespace VkStartup {
 
@@ -17,16 +21,45 @@ InitContext::InitContext(InitContextOptions options) : m_opt{std::move(options)}
   init();
 }
 
+InitContext::~InitContext() {
+  // Frames may still be in flight when the context goes out of scope
+  if (m_ctx.device()) {
+    vkDeviceWaitIdle(m_ctx.device());
+  }
+}
+
 void InitContext::init() {
   VkTrace("Running VkStartup");
-  init_instance();
-  init_physical_device();
-  init_logical_device();
-  init_queue_handles();
-  init_surfaces();
-  init_presentation();
-  init_swapchain();
-  init_vma();
+  const StartupProfiler::Activation activation{m_profiler};
+  // 'total' only counts finished spans, so the trace is outside of the init span
+  {
+    const ProfileScope scope{"InitContext::init"};
+    profile_stage("init_instance", &InitContext::init_instance);
+    profile_stage("init_physical_device", &InitContext::init_physical_device);
+    profile_stage("init_logical_device", &InitContext::init_logical_device);
+    profile_stage("init_queue_handles", &InitContext::init_queue_handles);
+    profile_stage("init_timelines", &InitContext::init_timelines);
+    profile_stage("init_deletion_queue", &InitContext::init_deletion_queue);
+    profile_stage("init_framebuffer_cache", &InitContext::init_framebuffer_cache);
+    profile_stage("init_surfaces", &InitContext::init_surfaces);
+    profile_stage("init_presentation", &InitContext::init_presentation);
+    profile_stage("init_swapchain", &InitContext::init_swapchain);
+    profile_stage("init_vma", &InitContext::init_vma);
+    profile_stage("init_offscreen", &InitContext::init_offscreen);
+    profile_stage("init_frames", &InitContext::init_frames);
+    profile_stage("init_pipeline_cache", &InitContext::init_pipeline_cache);
+    profile_stage("init_renderpass_cache", &InitContext::init_renderpass_cache);
+  }
+  VkTrace(std::string{"VkStartup initialized in "} + std::to_string(m_profiler.total().count() / 1000000) + " ms");
+}
+
+void InitContext::profile_stage(const char* name, void (InitContext::*stage)()) {
+  const ProfileScope scope{name};
+  (this->*stage)();
+}
+
+const StartupProfiler& InitContext::startup_profile() const {
+  return m_profiler;
 }
 
 void InitContext::init_instance() {
@@ -38,12 +71,27 @@ void InitContext::init_instance() {
   instance_flags |= VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
 #endif
 
+  // Perf lint requires validation and the performance message type
+  if (m_opt.perf_lint) {
+    m_opt.enable_validation = true;
+    m_opt.debug_filter.types |= VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+    m_opt.debug_filter.severities |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+    m_opt.debug_filter.perf_report = true;
+    m_opt.debug_filter.perf_report_path = m_opt.perf_lint_report_path;
+  }
+
   // Extensions
-  const auto supported_ext = ext_properties();
+  const auto supported_ext = [] {
+    const ProfileScope scope{"instance extension enumeration"};
+    return ext_properties();
+  }();
   auto ext = ext_to_load(supported_ext);
 
   // Layers
-  const auto supported_layers = layer_properties();
+  const auto supported_layers = [] {
+    const ProfileScope scope{"layer enumeration"};
+    return layer_properties();
+  }();
   auto layers = layers_to_load(supported_layers);
 
   // Check and add validation
@@ -61,77 +109,285 @@ void InitContext::init_instance() {
   VkInstanceCreateInfo create_info = CreateInfo::vk_instance_create_info(ext, layers, instance_flags, app_info);
 
   // Debug instance creation
-  const auto instance_debug = VkDebugger::instance_debug_create_info();
+  auto instance_debug = VkDebugger::instance_debug_create_info(m_opt.debug_filter);
   if (m_opt.enable_validation) {
     create_info.pNext = &instance_debug;
   }
 
+  // Best-practices checks
+  const std::vector validation_enables{VK_VALIDATION_FEATURE_ENABLE_BEST_PRACTICES_EXT};
+  const auto validation_features = CreateInfo::vk_validation_features(validation_enables);
+  if (m_opt.enable_validation && m_best_practices) {
+    instance_debug.pNext = &validation_features;
+  }
+
   // Create instance
-  m_ctx.instance = VkInstanceHandle{create_info};
+  {
+    const ProfileScope scope{"vkCreateInstance"};
+    m_ctx.instance = VkInstanceHandle{create_info};
+  }
 
   // Enable full debugging if its included in layers
   if (m_opt.enable_validation) {
-    m_ctx.debugger = std::make_unique<VkDebugger>(m_ctx.instance());
+    const ProfileScope scope{"debug messenger"};
+    m_ctx.debugger = std::make_unique<VkDebugger>(m_ctx.instance(), m_opt.debug_filter);
   }
 }
 
 void InitContext::init_physical_device() {
   // Swapchain support is only required if a surface loader exists:
   if (!m_opt.surface_loaders.empty()) {
-    const std::string swap_ext{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
-    if (std::ranges::find(m_opt.desired_device_ext, swap_ext) == m_opt.desired_device_ext.end() &&
-        std::ranges::find(m_opt.required_device_ext, swap_ext) == m_opt.required_device_ext.end()) {
-      m_opt.required_device_ext.emplace_back(swap_ext.c_str());
+    add_device_ext(m_opt.required_device_ext, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+  }
+
+  // Dynamic rendering is core in 1.3.  The extension's dependencies are core in 1.2.
+  if (m_opt.dynamic_rendering && m_opt.api_version >= VK_API_VERSION_1_2 && m_opt.api_version < VK_API_VERSION_1_3) {
+    add_device_ext(m_opt.desired_device_ext, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+  }
+
+  // Timeline semaphores are core in 1.2
+  if (m_opt.timeline_semaphores && m_opt.api_version >= VK_API_VERSION_1_1 &&
+      m_opt.api_version < VK_API_VERSION_1_2) {
+    add_device_ext(m_opt.desired_device_ext, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+  }
+
+  // Real budgets instead of VMA estimates.  VMA queries them through
+  // vkGetPhysicalDeviceMemoryProperties2 (core in 1.1).
+  if (m_opt.memory_budget && m_opt.api_version >= VK_API_VERSION_1_1) {
+    add_device_ext(m_opt.desired_device_ext, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+  }
+
+  // Allocator capabilities.  Dedicated allocations & vkBind*Memory2 are core in 1.1, buffer
+  // device addresses in 1.2 (the extension requires 1.1).
+  const auto& allocator = m_opt.allocator;
+  if (m_opt.api_version < VK_API_VERSION_1_1) {
+    request_device_ext(allocator.dedicated_allocation, VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME);
+    request_device_ext(allocator.dedicated_allocation, VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME);
+    request_device_ext(allocator.bind_memory2, VK_KHR_BIND_MEMORY_2_EXTENSION_NAME);
+  }
+  if (m_opt.api_version >= VK_API_VERSION_1_1) {
+    if (m_opt.api_version < VK_API_VERSION_1_2) {
+      request_device_ext(allocator.buffer_device_address, VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
     }
+    request_device_ext(allocator.memory_priority, VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
+    request_device_ext(allocator.device_coherent_memory, VK_AMD_DEVICE_COHERENT_MEMORY_EXTENSION_NAME);
+  } else if (allocator.buffer_device_address == CapabilityRequest::Required ||
+             allocator.memory_priority == CapabilityRequest::Required ||
+             allocator.device_coherent_memory == CapabilityRequest::Required) {
+    VkError("Buffer device address, memory priority & device coherent memory require an api_version of at least 1.1");
+    throw Exceptions::VkStartupException();
   }
 
   // User defined physical device selection or default:
   if (m_opt.phy_device_criteria) {
+    m_opt.phy_device_criteria->api_version(m_opt.api_version);
     m_ctx.phy_device_info = m_opt.phy_device_criteria->info();
   } else {
     PhysicalDeviceDefault phy_device{m_ctx.instance(), m_opt.desired_device_ext, m_opt.required_device_ext};
+    phy_device.queue_topology_policy(m_opt.queue_policy);
+    phy_device.selection_policy(m_opt.device_policy);
+    phy_device.api_version(m_opt.api_version);
     m_ctx.phy_device_info = phy_device.info();
   }
 }
 
 void InitContext::init_logical_device() {
-  auto& [vk_physical_device, vk_queue_family_indices, features_to_activate, device_extensions, depth_format,
-         stencil_support] = m_ctx.phy_device_info;
+  using VkShared::Enums::QueueFamily;
+  init_optional_features();
+  const auto& phy_info = m_ctx.phy_device_info;
+
+  // Assign queue indices for each family role.  Roles that resolve to the same family index
+  // get consecutive queues; once the family's queue count is reached, requests wrap around.
+  const std::map<QueueFamily, uint32_t> ordered_families{phy_info.vk_queue_family_indices.begin(),
+                                                         phy_info.vk_queue_family_indices.end()};
+  std::map<uint32_t, std::vector<float>> family_priorities;
+  m_queue_slots.clear();
+  for (const auto& [family, family_index] : ordered_families) {
+    std::vector<float> requested{1.0f};
+    const auto itr = m_opt.queue_priorities.find(family);
+    if (itr != m_opt.queue_priorities.end() && !itr->second.empty()) {
+      requested = itr->second;
+    }
+
+    uint32_t max_count{1};
+    if (family_index < phy_info.queue_family_properties.size()) {
+      max_count = std::max(phy_info.queue_family_properties[family_index].queueCount, 1u);
+    }
 
-  // Populate queue family create info for each unique queue family
-  std::unordered_set<uint32_t> unique_family_indices;
-  for (const auto& family_index : vk_queue_family_indices | std::views::values) {
-    unique_family_indices.insert(family_index);
+    auto& priorities = family_priorities[family_index];
+    auto& slots = m_queue_slots[family];
+    for (const float priority : requested) {
+      if (priorities.size() < max_count) {
+        slots.emplace_back(static_cast<uint32_t>(priorities.size()), std::clamp(priority, 0.0f, 1.0f));
+        priorities.push_back(slots.back().second);
+      } else {
+        const auto shared_index = static_cast<uint32_t>(slots.size() % priorities.size());
+        slots.emplace_back(shared_index, priorities[shared_index]);
+      }
+    }
+
+    if (requested.size() > max_count) {
+      VkWarning("Requested " + std::to_string(requested.size()) + " queues for family index " +
+                std::to_string(family_index) + " but only " + std::to_string(max_count) + " are available");
+    }
   }
 
-  // Create device queue info for each unique queue
+  // Create device queue info for each unique queue family
   std::vector<VkDeviceQueueCreateInfo> all_queue_info;
-  all_queue_info.reserve(unique_family_indices.size());
-
-  constexpr float queue_priority{1.0f};
-  for (const auto& index : unique_family_indices) {
-    auto queue_info = CreateInfo::vk_device_queue_create_info(index);
-    queue_info.pQueuePriorities = &queue_priority;
-    all_queue_info.push_back(queue_info);
+  all_queue_info.reserve(family_priorities.size());
+  for (const auto& [family_index, priorities] : family_priorities) {
+    all_queue_info.push_back(CreateInfo::vk_device_queue_create_info(family_index, priorities));
   }
 
   // Create logical device
-  auto logical_info = CreateInfo::vk_device_create_info(all_queue_info, features_to_activate, device_extensions,
-                                                        m_opt.required_layers);
-  m_ctx.device = VkDeviceHandle{logical_info, vk_physical_device};
+  auto logical_info = CreateInfo::vk_device_create_info(all_queue_info, phy_info.features_to_activate,
+                                                        phy_info.device_ext, m_opt.required_layers);
+
+  // Extended features replace 'pEnabledFeatures' (VkPhysicalDeviceFeatures2 requires 1.1)
+  auto feature_chain = phy_info.feature_chain_to_activate;
+  if (phy_info.api_version >= VK_API_VERSION_1_1) {
+    feature_chain.features2.features = phy_info.features_to_activate;
+    logical_info.pEnabledFeatures = nullptr;
+    logical_info.pNext = feature_chain.link(phy_info.api_version, phy_info.device_ext);
+  }
+  {
+    const ProfileScope scope{"vkCreateDevice"};
+    m_ctx.device = VkDeviceHandle{logical_info, phy_info.vk_phy_device};
+  }
+
+  // Core entry points are only exposed when the device api version is high enough
+  if (phy_info.dynamic_rendering) {
+    m_ctx.cmd_begin_rendering = reinterpret_cast<PFN_vkCmdBeginRendering>(
+        device_function("vkCmdBeginRendering", "vkCmdBeginRenderingKHR"));
+    m_ctx.cmd_end_rendering =
+        reinterpret_cast<PFN_vkCmdEndRendering>(device_function("vkCmdEndRendering", "vkCmdEndRenderingKHR"));
+  }
+  if (phy_info.timeline_semaphore) {
+    m_ctx.wait_semaphores =
+        reinterpret_cast<PFN_vkWaitSemaphores>(device_function("vkWaitSemaphores", "vkWaitSemaphoresKHR"));
+    m_ctx.signal_semaphore =
+        reinterpret_cast<PFN_vkSignalSemaphore>(device_function("vkSignalSemaphore", "vkSignalSemaphoreKHR"));
+    m_ctx.get_semaphore_counter_value = reinterpret_cast<PFN_vkGetSemaphoreCounterValue>(
+        device_function("vkGetSemaphoreCounterValue", "vkGetSemaphoreCounterValueKHR"));
+  }
+}
+
+void InitContext::init_optional_features() {
+  // Features that are enabled automatically when the device can chain & supports them
+  auto& phy_info = m_ctx.phy_device_info;
+  const auto available = phy_info.supported_features.available(phy_info.api_version, phy_info.device_ext);
+  auto& to_activate = phy_info.feature_chain_to_activate;
+
+  phy_info.dynamic_rendering = m_opt.dynamic_rendering && available.dynamic_rendering.dynamicRendering == VK_TRUE;
+  if (phy_info.dynamic_rendering) {
+    to_activate.dynamic_rendering.dynamicRendering = VK_TRUE;
+  }
+
+  phy_info.timeline_semaphore =
+      m_opt.timeline_semaphores && available.timeline_semaphore.timelineSemaphore == VK_TRUE;
+  if (phy_info.timeline_semaphore) {
+    to_activate.timeline_semaphore.timelineSemaphore = VK_TRUE;
+  }
+
+  phy_info.memory_budget = m_opt.memory_budget && phy_info.api_version >= VK_API_VERSION_1_1 &&
+                           std::ranges::any_of(phy_info.device_ext, [](const char* ext) {
+                             return std::string_view{ext} == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+                           });
+
+  // Allocator capabilities
+  const auto has_ext = [&phy_info](const char* name) {
+    return std::ranges::any_of(phy_info.device_ext, [name](const char* ext) { return std::string_view{ext} == name; });
+  };
+  const auto& allocator = m_opt.allocator;
+  const bool core_1_1 = phy_info.api_version >= VK_API_VERSION_1_1;
+  phy_info.dedicated_allocation =
+      allocator.dedicated_allocation != CapabilityRequest::Off &&
+      (core_1_1 || (has_ext(VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME) &&
+                    has_ext(VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME)));
+  phy_info.bind_memory2 =
+      allocator.bind_memory2 != CapabilityRequest::Off && (core_1_1 || has_ext(VK_KHR_BIND_MEMORY_2_EXTENSION_NAME));
+  if (phy_info.api_version < VK_API_VERSION_1_1) {
+    // Required extensions were checked during device selection; the device api version can
+    // still be lower than the instance api version.
+    if ((allocator.dedicated_allocation == CapabilityRequest::Required && !phy_info.dedicated_allocation) ||
+        (allocator.bind_memory2 == CapabilityRequest::Required && !phy_info.bind_memory2)) {
+      VkError("The physical device does not support the allocator capabilities required by InitContextOptions");
+      throw Exceptions::VkStartupException();
+    }
+  }
+
+  const auto enable = [](const CapabilityRequest request, const VkBool32 supported, VkBool32& feature,
+                         const char* name) {
+    if (request == CapabilityRequest::Off) {
+      return feature == VK_TRUE;
+    }
+    if (supported == VK_TRUE) {
+      feature = VK_TRUE;
+      return true;
+    }
+    if (request == CapabilityRequest::Required) {
+      VkError(std::string{"The physical device does not support the required feature "} + name);
+      throw Exceptions::VkStartupException();
+    }
+    return false;
+  };
+  phy_info.buffer_device_address =
+      enable(allocator.buffer_device_address, available.buffer_device_address.bufferDeviceAddress,
+             to_activate.buffer_device_address.bufferDeviceAddress, "bufferDeviceAddress");
+  phy_info.memory_priority = enable(allocator.memory_priority, available.memory_priority.memoryPriority,
+                                    to_activate.memory_priority.memoryPriority, "memoryPriority");
+  phy_info.device_coherent_memory =
+      enable(allocator.device_coherent_memory, available.device_coherent_memory.deviceCoherentMemory,
+             to_activate.device_coherent_memory.deviceCoherentMemory, "deviceCoherentMemory");
+}
+
+void InitContext::init_timelines() {
+  if (!m_ctx.phy_device_info.timeline_semaphore) {
+    return;
+  }
+  // Queues shared between families share one timeline
+  for (const auto& queues : m_ctx.queues | std::views::values) {
+    for (const auto& queue : queues) {
+      if (!m_ctx.timelines.contains(queue.handle)) {
+        m_ctx.timelines.emplace(queue.handle, std::make_unique<QueueTimeline>(m_ctx, queue));
+      }
+    }
+  }
+}
+
+PFN_vkVoidFunction InitContext::device_function(const char* core_name, const char* khr_name) const {
+  const auto function = vkGetDeviceProcAddr(m_ctx.device(), core_name);
+  return function ? function : vkGetDeviceProcAddr(m_ctx.device(), khr_name);
+}
+
+void InitContext::add_device_ext(std::vector<const char*>& extensions, const char* ext) const {
+  const auto matches = [ext](const char* value) { return std::string_view{value} == ext; };
+  if (std::ranges::none_of(m_opt.desired_device_ext, matches) &&
+      std::ranges::none_of(m_opt.required_device_ext, matches)) {
+    extensions.push_back(ext);
+  }
+}
+
+void InitContext::request_device_ext(const CapabilityRequest request, const char* ext) {
+  if (request == CapabilityRequest::Desired) {
+    add_device_ext(m_opt.desired_device_ext, ext);
+  } else if (request == CapabilityRequest::Required) {
+    add_device_ext(m_opt.required_device_ext, ext);
+  }
 }
 
 void InitContext::init_queue_handles() {
   for (const auto& [family, family_index] : m_ctx.phy_device_info.vk_queue_family_indices) {
-    if (!m_ctx.queues.contains(family)) {
-      QueueIndexHandle queue{family_index, VK_NULL_HANDLE};
-      // Only one queue per family is being used (hence the 0).
-      vkGetDeviceQueue(m_ctx.device(), family_index, 0, &queue.handle);
+    auto& queues = m_ctx.queues[family];
+    queues.clear();
+    for (const auto& [queue_index, priority] : m_queue_slots.at(family)) {
+      QueueIndexHandle queue{family_index, VK_NULL_HANDLE, queue_index, priority};
+      vkGetDeviceQueue(m_ctx.device(), family_index, queue_index, &queue.handle);
       if (!queue.handle) {
         VkError("Unable to create queue handle");
         throw Exceptions::VkStartupException();
       }
-      m_ctx.queues[family] = queue;
+      queues.push_back(queue);
     }
   }
 }
@@ -139,6 +395,7 @@ void InitContext::init_queue_handles() {
 void InitContext::init_surfaces() {
   if (!m_opt.surface_loaders.empty()) {
     for (auto& surface_loader : m_opt.surface_loaders) {
+      const ProfileScope scope{"surface: " + surface_loader->id()};
       surface_loader->init(m_ctx.instance());
       m_ctx.swap_ctx[surface_loader->id()].surface_loader = std::move(surface_loader);
     }
@@ -150,6 +407,9 @@ void InitContext::init_surfaces() {
 void InitContext::init_presentation() {
   if (!m_ctx.swap_ctx.empty()) {
     for (auto& [id, swap_ctx] : m_ctx.swap_ctx) {
+      if (swap_ctx.is_offscreen()) {
+        continue;
+      }
       const auto vk_physical_device = m_ctx.phy_device_info.vk_phy_device;
 
       uint32_t queue_family_count = 0;
@@ -173,63 +433,251 @@ void InitContext::init_presentation() {
 }
 
 void InitContext::init_swapchain() {
-  // Initialize swapchain
-  if (!m_ctx.swap_ctx.empty()) {
-    for (auto& swap_ctx : m_ctx.swap_ctx | std::views::values) {
-      // Supported swapchain details based on the user defined physical device selection
-      const auto supported_swap_details = Swapchain::query_swap_support(m_ctx.phy_device_info.vk_phy_device,
-                                                                        swap_ctx.surface_loader->surface());
-
-      // Swapchain creation details (likely the same for all windows but not required)
-      swap_ctx.swap_format_details = swap_ctx.surface_loader->select_swapchain_format(supported_swap_details);
-      const auto& [format, present_mode, extent, image_count, pretransform, usage_flags] = swap_ctx.swap_format_details;
-
-      // No swapchain / images will be made when extent is zero
-      if (extent.height == 0 || extent.width == 0) {
-        break;
-      }
+  // Initialize swapchain.  Surfaces with a zero extent are skipped until they are remade.
+  for (auto& [id, swap_ctx] : m_ctx.swap_ctx) {
+    if (!swap_ctx.is_offscreen()) {
+      static_cast<void>(make_swapchain(id, swap_ctx));
+    }
+  }
+}
 
-      // Initialize the swapchain using 'selected_swapchain_details'
-      const auto unique_queues_vec = unique_queues();  // Sharing mode
-      auto info = CreateInfo::vk_swapchain_create_info(unique_queues_vec);
-      info.minImageCount = image_count;
-      info.imageFormat = format.format;
-      info.imageColorSpace = format.colorSpace;
-      info.imageExtent = extent;
-      info.preTransform = pretransform;
-      info.presentMode = present_mode;
-      info.imageUsage = usage_flags;
-      info.surface = swap_ctx.surface_loader->surface();
-      info.oldSwapchain = swap_ctx.swapchain();
-      info.clipped = VK_TRUE;
-      info.imageArrayLayers = 1;
-      info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-      swap_ctx.swapchain = VkSwapchainHandle{info, m_ctx.device()};
-
-      // Set swapchain images
-      // Count is required because 'min image count' above is a request that isn't guarenteed
-      uint32_t img_count{0};
-      vkGetSwapchainImagesKHR(m_ctx.device(), swap_ctx.swapchain(), &img_count, nullptr);
-      swap_ctx.rp_buffers.vk_images.resize(img_count);
-
-      auto& [width, height, renderpass, vk_imgs, img_views, framebuffers] = swap_ctx.rp_buffers;
-      width = info.imageExtent.width;
-      height = info.imageExtent.height;
-      vkGetSwapchainImagesKHR(m_ctx.device(), swap_ctx.swapchain(), &img_count, vk_imgs.data());
-
-      // Set image views
-      img_views.clear();  // Handle remakes
-      for (size_t i = 0; i < img_count; i++) {
-        auto image_view_info = CreateInfo::vk_image_view_create_info(vk_imgs[i]);
-        image_view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        image_view_info.format = format.format;
-        image_view_info.components = VkComponentMapping{VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
-                                                        VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY};
-        image_view_info.subresourceRange = VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-        img_views.emplace_back(image_view_info, m_ctx.device());
-      }
+bool InitContext::make_swapchain(const std::string& id, VkSwapchainContext& swap_ctx) {
+  const ProfileScope scope{"swapchain: " + id};
+
+  // Supported swapchain details based on the user defined physical device selection
+  const auto supported_swap_details = Swapchain::query_swap_support(m_ctx.phy_device_info.vk_phy_device,
+                                                                    swap_ctx.surface_loader->surface());
+
+  // Swapchain creation details (likely the same for all windows but not required)
+  swap_ctx.swap_format_details = swap_ctx.surface_loader->select_swapchain_format(supported_swap_details);
+  const auto& [format, present_mode, extent, image_count, pretransform, usage_flags] = swap_ctx.swap_format_details;
+
+  // No swapchain / images will be made when extent is zero (e.g. minimized)
+  if (extent.height == 0 || extent.width == 0) {
+    return false;
+  }
+
+  // Initialize the swapchain using 'selected_swapchain_details'
+  const auto unique_queues_vec = unique_queues(swap_ctx);  // Sharing mode
+  auto info = CreateInfo::vk_swapchain_create_info(unique_queues_vec);
+  info.minImageCount = image_count;
+  info.imageFormat = format.format;
+  info.imageColorSpace = format.colorSpace;
+  info.imageExtent = extent;
+  info.preTransform = pretransform;
+  info.presentMode = present_mode;
+  info.imageUsage = usage_flags;
+  info.surface = swap_ctx.surface_loader->surface();
+  info.clipped = VK_TRUE;
+  info.imageArrayLayers = 1;
+  info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+
+  // The old swapchain lets presentation continue during the transition.  It is retired
+  // rather than destroyed since frames in flight may still use its images.  Presents aren't
+  // tracked by any timeline, so it is held for a full ring of frames.
+  VkSwapchainHandle old_swapchain{std::move(swap_ctx.swapchain)};
+  info.oldSwapchain = old_swapchain();
+  swap_ctx.swapchain = VkSwapchainHandle{info, m_ctx.device()};
+  m_ctx.deletion_queue->retire(std::move(old_swapchain), std::max(m_opt.frames_in_flight, 1u));
+
+  // Set swapchain images
+  // Count is required because 'min image count' above is a request that isn't guarenteed
+  uint32_t img_count{0};
+  vkGetSwapchainImagesKHR(m_ctx.device(), swap_ctx.swapchain(), &img_count, nullptr);
+  swap_ctx.rp_buffers.vk_images.resize(img_count);
+
+  auto& [width, height, renderpass, vk_imgs, img_views, framebuffers] = swap_ctx.rp_buffers;
+  width = info.imageExtent.width;
+  height = info.imageExtent.height;
+  vkGetSwapchainImagesKHR(m_ctx.device(), swap_ctx.swapchain(), &img_count, vk_imgs.data());
+
+  // Set image views.  Old views & their framebuffers may still be in use by frames in flight.
+  m_ctx.deletion_queue->retire(m_ctx.framebuffer_cache->invalidate(id));
+  m_ctx.deletion_queue->retire(std::move(img_views));
+  framebuffers.clear();
+  img_views.clear();  // Handle remakes
+  for (size_t i = 0; i < img_count; i++) {
+    auto image_view_info = CreateInfo::vk_image_view_create_info(vk_imgs[i]);
+    image_view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    image_view_info.format = format.format;
+    image_view_info.components = VkComponentMapping{VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+                                                    VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY};
+    image_view_info.subresourceRange = VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    img_views.emplace_back(image_view_info, m_ctx.device());
+  }
+
+  init_image_sync(swap_ctx);
+  return true;
+}
+
+void InitContext::init_frames() {
+  const uint32_t frame_count = std::max(m_opt.frames_in_flight, 1u);
+  for (auto& swap_ctx : m_ctx.swap_ctx | std::views::values) {
+    auto& frames = swap_ctx.frames.frames;
+    frames.clear();
+    frames.reserve(frame_count);
+    for (uint32_t i = 0; i < frame_count; i++) {
+      // Fences start signaled so the first wait on each frame returns immediately
+      auto& frame = frames.emplace_back();
+      frame.image_available = VkSemaphoreHandle{CreateInfo::vk_semaphore_create_info(), m_ctx.device()};
+      frame.in_flight = VkFenceHandle{CreateInfo::vk_fence_create_info(VK_FENCE_CREATE_SIGNALED_BIT), m_ctx.device()};
+    }
+    swap_ctx.frames.frame_index = 0;
+  }
+}
+
+void InitContext::init_image_sync(VkSwapchainContext& swap_ctx) const {
+  const auto img_count = swap_ctx.rp_buffers.vk_images.size();
+  auto& [frames, render_finished, images_in_flight, frame_index, image_index] = swap_ctx.frames;
+
+  // Offscreen images aren't presented, so nothing waits on a render finished semaphore.
+  // Semaphores from a previous swapchain may still be waited on by a queued present, which
+  // no timeline tracks, so they are held for a full ring of frames.
+  m_ctx.deletion_queue->retire(std::move(render_finished), std::max(m_opt.frames_in_flight, 1u));
+  render_finished.clear();
+  if (!swap_ctx.is_offscreen()) {
+    for (size_t i = 0; i < img_count; i++) {
+      render_finished.emplace_back(CreateInfo::vk_semaphore_create_info(), m_ctx.device());
+    }
+  }
+  images_in_flight.assign(img_count, VK_NULL_HANDLE);
+}
+
+std::optional<FrameInfo> InitContext::begin_frame(const std::string& id) {
+  auto& swap_ctx = m_ctx.swap_ctx.at(id);
+  auto& ring = swap_ctx.frames;
+  const bool offscreen = swap_ctx.is_offscreen();
+  if ((!offscreen && !swap_ctx.swapchain()) || ring.frames.empty() || ring.images_in_flight.empty()) {
+    return std::nullopt;
+  }
+
+  const auto& frame = ring.frames[ring.frame_index];
+  VkFence in_flight = frame.in_flight();
+  VkCheck(vkWaitForFences(m_ctx.device(), 1, &in_flight, VK_TRUE, UINT64_MAX), Exceptions::VkStartupException());
+  static_cast<void>(m_ctx.deletion_queue->collect());
+  begin_context_frame(id);
+
+  uint32_t image_index{0};
+  if (offscreen) {
+    // Offscreen images are handed out round robin
+    image_index = (ring.image_index + 1) % static_cast<uint32_t>(ring.images_in_flight.size());
+  } else {
+    const auto result = vkAcquireNextImageKHR(m_ctx.device(), swap_ctx.swapchain(), UINT64_MAX,
+                                              frame.image_available(), VK_NULL_HANDLE, &image_index);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+      // Only this surface is rebuilt; other surfaces keep rendering
+      static_cast<void>(remake_swapchain(id));
+      return std::nullopt;
+    }
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+      VkError("Unable to acquire swapchain image for surface id: " + id);
+      throw Exceptions::VkStartupException();
     }
   }
+
+  // An older frame may still be rendering to this image
+  if (VkFence image_fence = ring.images_in_flight[image_index]; image_fence && image_fence != in_flight) {
+    VkCheck(vkWaitForFences(m_ctx.device(), 1, &image_fence, VK_TRUE, UINT64_MAX), Exceptions::VkStartupException());
+  }
+  ring.images_in_flight[image_index] = in_flight;
+  ring.image_index = image_index;
+
+  // Only reset once work is guaranteed to be submitted for this frame
+  VkCheck(vkResetFences(m_ctx.device(), 1, &in_flight), Exceptions::VkStartupException());
+
+  if (offscreen) {
+    return FrameInfo{ring.frame_index, image_index, VK_NULL_HANDLE, VK_NULL_HANDLE, in_flight};
+  }
+  return FrameInfo{ring.frame_index, image_index, frame.image_available(), ring.render_finished[image_index](),
+                   in_flight};
+}
+
+bool InitContext::end_frame(const std::string& id, const std::vector<VkCommandBuffer>& cmd_buffers,
+                            const std::vector<VkSemaphore>& signal_semaphores) {
+  using VkShared::Enums::QueueFamily;
+  auto& swap_ctx = m_ctx.swap_ctx.at(id);
+  auto& ring = swap_ctx.frames;
+  const auto& frame = ring.frames[ring.frame_index];
+  const bool offscreen = swap_ctx.is_offscreen();
+
+  // Submit
+  if (offscreen) {
+    submit_graphics(cmd_buffers, {}, signal_semaphores, frame.in_flight());
+    ring.frame_index = (ring.frame_index + 1) % static_cast<uint32_t>(ring.frames.size());
+    return true;
+  }
+
+  const VkSemaphore signal_semaphore = ring.render_finished[ring.image_index]();
+  std::vector<VkSemaphore> all_signal_semaphores{signal_semaphore};
+  all_signal_semaphores.insert(all_signal_semaphores.end(), signal_semaphores.begin(), signal_semaphores.end());
+
+  const SemaphoreWait image_wait{frame.image_available(), 0, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+  submit_graphics(cmd_buffers, {image_wait}, all_signal_semaphores, frame.in_flight());
+
+  // Present
+  const VkSwapchainKHR swapchain = swap_ctx.swapchain();
+  auto present_info = CreateInfo::vk_present_info();
+  present_info.waitSemaphoreCount = 1;
+  present_info.pWaitSemaphores = &signal_semaphore;
+  present_info.swapchainCount = 1;
+  present_info.pSwapchains = &swapchain;
+  present_info.pImageIndices = &ring.image_index;
+  const auto result = vkQueuePresentKHR(swap_ctx.present_queue.handle, &present_info);
+
+  ring.frame_index = (ring.frame_index + 1) % static_cast<uint32_t>(ring.frames.size());
+
+  if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+    static_cast<void>(remake_swapchain(id));
+    return false;
+  }
+  if (result != VK_SUCCESS) {
+    VkError("Unable to present swapchain image for surface id: " + id);
+    throw Exceptions::VkStartupException();
+  }
+  return true;
+}
+
+void InitContext::begin_context_frame(const std::string& id) {
+  // 'begin_frame' runs once per surface.  A surface beginning its second frame since the last
+  // update starts a new context frame, so N surfaces (or offscreen targets) don't advance the
+  // VMA frame index & evaluate memory pressure N times per frame.
+  if (!m_frame_surfaces.empty() && m_frame_surfaces.insert(id).second) {
+    return;
+  }
+  m_frame_surfaces.clear();
+  m_frame_surfaces.insert(id);
+  m_ctx.deletion_queue->advance_frame();
+  m_ctx.memory_budget->update(m_frame_counter++);
+}
+
+void InitContext::submit_graphics(const std::vector<VkCommandBuffer>& cmd_buffers,
+                                  const std::vector<SemaphoreWait>& waits,
+                                  const std::vector<VkSemaphore>& signal_semaphores, VkFence fence) const {
+  using VkShared::Enums::QueueFamily;
+
+  // Timeline submissions are tracked by the deletion queue
+  if (!m_ctx.timelines.empty()) {
+    static_cast<void>(m_ctx.timeline(QueueFamily::Graphics).submit(cmd_buffers, waits, signal_semaphores, fence));
+    return;
+  }
+
+  std::vector<VkSemaphore> wait_semaphores{};
+  std::vector<VkPipelineStageFlags> wait_stages{};
+  for (const auto& [semaphore, value, stage] : waits) {
+    wait_semaphores.push_back(semaphore);
+    wait_stages.push_back(stage);
+  }
+
+  auto submit_info = CreateInfo::vk_submit_info();
+  submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+  submit_info.pWaitSemaphores = wait_semaphores.data();
+  submit_info.pWaitDstStageMask = wait_stages.data();
+  submit_info.commandBufferCount = static_cast<uint32_t>(cmd_buffers.size());
+  submit_info.pCommandBuffers = cmd_buffers.data();
+  submit_info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
+  submit_info.pSignalSemaphores = signal_semaphores.data();
+  VkCheck(vkQueueSubmit(m_ctx.queue(QueueFamily::Graphics).handle, 1, &submit_info, fence),
+          Exceptions::VkStartupException());
 }
 
 bool InitContext::remake_swapchain() {
@@ -240,10 +688,138 @@ bool InitContext::remake_swapchain() {
   });
 }
 
+bool InitContext::remake_swapchain(const std::string& id) {
+  auto& swap_ctx = m_ctx.swap_ctx.at(id);
+  if (swap_ctx.is_offscreen()) {
+    return true;
+  }
+  return make_swapchain(id, swap_ctx);
+}
+
 void InitContext::init_vma() {
-  auto info = CreateInfo::vma_allocator_info(m_ctx.instance(), m_ctx.device(), m_ctx.phy_device_info.vk_phy_device,
-                                             m_opt.api_version);
+  const auto& phy_info = m_ctx.phy_device_info;
+  // The KHR flags only apply to 1.0 devices; VMA uses the core entry points otherwise
+  VmaAllocatorCreateFlags flags{0};
+  if (phy_info.api_version < VK_API_VERSION_1_1 && phy_info.dedicated_allocation) {
+    flags |= VMA_ALLOCATOR_CREATE_KHR_DEDICATED_ALLOCATION_BIT;
+  }
+  if (phy_info.api_version < VK_API_VERSION_1_1 && phy_info.bind_memory2) {
+    flags |= VMA_ALLOCATOR_CREATE_KHR_BIND_MEMORY2_BIT;
+  }
+  if (phy_info.memory_budget) {
+    flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+  }
+  if (phy_info.buffer_device_address) {
+    flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+  }
+  if (phy_info.memory_priority) {
+    flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT;
+  }
+  if (phy_info.device_coherent_memory) {
+    flags |= VMA_ALLOCATOR_CREATE_AMD_DEVICE_COHERENT_MEMORY_BIT;
+  }
+
+  // The device api version (VMA must not use entry points above it)
+  auto info = CreateInfo::vma_allocator_info(m_ctx.instance(), m_ctx.device(), phy_info.vk_phy_device,
+                                             phy_info.api_version, flags);
   m_ctx.mem_alloc = VmaAllocatorHandle{info};
+  m_ctx.memory_budget = std::make_unique<MemoryBudget>(m_ctx.mem_alloc(), phy_info.vk_phy_device,
+                                                       phy_info.memory_budget, m_opt.memory_pressure_thresholds);
+}
+
+void InitContext::init_offscreen() {
+  using VkShared::Enums::QueueFamily;
+
+  for (const auto& [id, extent, format, image_count, usage_flags, depth] : m_opt.offscreen_targets) {
+    if (m_ctx.swap_ctx.contains(id)) {
+      VkError("The id: " + id + " already exists for a surface or offscreen target.  Ids must be unique!");
+      throw Exceptions::VkStartupException();
+    }
+    if (extent.width == 0 || extent.height == 0) {
+      VkError("Offscreen target: " + id + " requires a non zero extent");
+      throw Exceptions::VkStartupException();
+    }
+
+    auto& swap_ctx = m_ctx.swap_ctx[id];
+    auto& details = swap_ctx.swap_format_details;
+    details.format = VkSurfaceFormatKHR{format, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+    details.extent = extent;
+    details.image_count = std::max(image_count, 1u);
+    details.usage_flags = usage_flags;
+
+    // Offscreen work is released on the graphics queue
+    swap_ctx.present_queue = m_ctx.queue(QueueFamily::Graphics);
+
+    // Images are shared with the transfer family so they can be read back without
+    // queue family ownership transfers
+    std::unordered_set<uint32_t> families{m_ctx.queue(QueueFamily::Graphics).family_index,
+                                          m_ctx.queue(QueueFamily::Transfer).family_index};
+    const std::vector<uint32_t> unique_families{families.begin(), families.end()};
+
+    const auto alloc_info = CreateInfo::vma_allocation_create_info(VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                                                                   VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT);
+
+    auto& [width, height, renderpass, vk_imgs, img_views, framebuffers] = swap_ctx.rp_buffers;
+    auto& [color_images, depth_images, depth_views] = swap_ctx.offscreen;
+    width = extent.width;
+    height = extent.height;
+    vk_imgs.clear();
+
+    for (uint32_t i = 0; i < details.image_count; i++) {
+      // Color
+      const auto color_info = CreateInfo::vk_image_create_info(format, extent, usage_flags, unique_families);
+      const auto& color_image = color_images.emplace_back(color_info, alloc_info, m_ctx.mem_alloc());
+      vk_imgs.push_back(color_image());
+
+      auto color_view_info = CreateInfo::vk_image_view_create_info(color_image());
+      color_view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+      color_view_info.format = format;
+      color_view_info.components = VkComponentMapping{VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+                                                      VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY};
+      color_view_info.subresourceRange = VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+      img_views.emplace_back(color_view_info, m_ctx.device());
+
+      // Depth (optional)
+      if (depth) {
+        const auto depth_format = m_ctx.phy_device_info.depth_format;
+        const auto depth_info = CreateInfo::vk_image_create_info(
+            depth_format, extent, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, unique_families);
+        const auto& depth_image = depth_images.emplace_back(depth_info, alloc_info, m_ctx.mem_alloc());
+
+        VkImageAspectFlags aspect{VK_IMAGE_ASPECT_DEPTH_BIT};
+        if (m_ctx.phy_device_info.depth_format_supports_stencil) {
+          aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        auto depth_view_info = CreateInfo::vk_image_view_create_info(depth_image());
+        depth_view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        depth_view_info.format = depth_format;
+        depth_view_info.components = color_view_info.components;
+        depth_view_info.subresourceRange = VkImageSubresourceRange{aspect, 0, 1, 0, 1};
+        depth_views.emplace_back(depth_view_info, m_ctx.device());
+      }
+    }
+
+    // Start the round robin so the first acquired image is index 0
+    swap_ctx.frames.image_index = details.image_count - 1;
+    init_image_sync(swap_ctx);
+  }
+}
+
+void InitContext::init_pipeline_cache() {
+  m_ctx.pipeline_cache = std::make_unique<PipelineCache>(m_ctx.device(), m_ctx.phy_device_info.vk_phy_device,
+                                                         m_opt.pipeline_cache_path);
+}
+
+void InitContext::init_deletion_queue() {
+  m_ctx.deletion_queue = std::make_unique<DeletionQueue>(m_ctx);
+}
+
+void InitContext::init_framebuffer_cache() {
+  m_ctx.framebuffer_cache = std::make_unique<FramebufferCache>(m_ctx.device());
+}
+
+void InitContext::init_renderpass_cache() {
+  m_ctx.renderpass_cache = std::make_unique<RenderpassCache>(m_ctx.device(), m_ctx.framebuffer_cache.get());
 }
 
 std::vector<const char*> InitContext::ext_to_load(const std::vector<VkExtensionProperties>& supported_ext) const {
@@ -270,11 +846,11 @@ std::vector<const char*> InitContext::ext_to_load(const std::vector<VkExtensionP
   return extensions;
 }
 
-std::vector<VkExtensionProperties> InitContext::ext_properties() {
+std::vector<VkExtensionProperties> InitContext::ext_properties(const char* layer) {
   uint32_t ext_count{0};
-  vkEnumerateInstanceExtensionProperties(nullptr, &ext_count, nullptr);
+  vkEnumerateInstanceExtensionProperties(layer, &ext_count, nullptr);
   std::vector<VkExtensionProperties> ext{ext_count};
-  vkEnumerateInstanceExtensionProperties(nullptr, &ext_count, ext.data());
+  vkEnumerateInstanceExtensionProperties(layer, &ext_count, ext.data());
   return ext;
 }
 
@@ -338,6 +914,17 @@ void InitContext::add_validation_requirements(std::vector<const char*>& ext,
         layer_supported(supported_layers, val_layer_name) && ext_supported(supported_ext, debug_ext_name)) {
       layers.push_back(val_layer_name);
       ext.push_back(debug_ext_name);
+
+      // VK_EXT_validation_features is provided by the validation layer
+      const auto features_ext_name = VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME;
+      if (m_opt.perf_lint) {
+        if (ext_supported(ext_properties(val_layer_name), features_ext_name)) {
+          ext.push_back(features_ext_name);
+          m_best_practices = true;
+        } else {
+          VkWarning("VK_EXT_validation_features is not supported; perf lint only reports default validation");
+        }
+      }
     } else {
       m_opt.enable_validation = false;
       VkWarning("Validation or debug extension not supported");
@@ -345,19 +932,12 @@ void InitContext::add_validation_requirements(std::vector<const char*>& ext,
   }
 }
 
-std::vector<uint32_t> InitContext::unique_queues() const {
-  // Check other family queues (based on the VkPhysicalDevice queues)
+std::vector<uint32_t> InitContext::unique_queues(const VkSwapchainContext& swap_ctx) const {
+  // Swapchain images are only accessed by the graphics and presentation queues.  Dedicated
+  // transfer / compute families are left out so images don't become concurrent needlessly.
   std::unordered_set<uint32_t> unique_queues;
-
-  // Standard queues
-  for (auto& [family_index, handle] : m_ctx.queues | std::views::values) {  // NOLINT(misc-misplaced-const)
-    unique_queues.insert(family_index);
-  }
-
-  // Swapchain queues (can vary if multiple surfaces)
-  for (const auto& swap_ctx : m_ctx.swap_ctx | std::views::values) {
-    unique_queues.insert(swap_ctx.present_queue.family_index);
-  }
+  unique_queues.insert(m_ctx.queue(VkShared::Enums::QueueFamily::Graphics).family_index);
+  unique_queues.insert(swap_ctx.present_queue.family_index);
 
   return {unique_queues.begin(), unique_queues.end()};
 }
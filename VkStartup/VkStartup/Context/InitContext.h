@@ -2,12 +2,44 @@
 #include "VkStartup/Context/Context.h"
 #include "VkStartup/Context/PhysicalDevice.h"
 #include "VkStartup/Context/SurfaceLoader.h"
+#include "VkStartup/Context/Offscreen.h"
+#include "VkStartup/Misc/Profiler.h"
 #include <vector>
 #include <unordered_set>
+#include <string>
 #include <memory>
+#include <filesystem>
+#include <optional>
+#include <utility>
 
 namespace VkStartup {
 
+enum class CapabilityRequest {
+  Off,
+  // Enabled when the device supports it
+  Desired,
+  // Initialization fails when the device does not support it
+  Required
+};
+
+// Device capabilities the VMA allocator can use.  The allocator flags are derived from what
+// was actually enabled on the device (see 'PhysicalDeviceInfo').
+struct AllocatorOptions {
+  // Dedicated allocations for resources the driver prefers them for.  Core in 1.1;
+  // VK_KHR_dedicated_allocation & VK_KHR_get_memory_requirements2 with an api_version of 1.0.
+  CapabilityRequest dedicated_allocation{CapabilityRequest::Desired};
+  // vkBind*Memory2 (allocation pNext chains).  Core in 1.1; VK_KHR_bind_memory2 with 1.0.
+  CapabilityRequest bind_memory2{CapabilityRequest::Desired};
+  // VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT buffers.  Core in 1.2;
+  // VK_KHR_buffer_device_address with an api_version of 1.1.
+  CapabilityRequest buffer_device_address{CapabilityRequest::Off};
+  // VmaAllocationCreateInfo::priority for dedicated allocations (VK_EXT_memory_priority, 1.1+)
+  CapabilityRequest memory_priority{CapabilityRequest::Off};
+  // Device coherent / uncached memory types (VK_AMD_device_coherent_memory, 1.1+).  Without
+  // it VMA skips these memory types.
+  CapabilityRequest device_coherent_memory{CapabilityRequest::Off};
+};
+
 struct InitContextOptions {
   // Instance
   uint32_t api_version{VK_API_VERSION_1_0};
@@ -16,37 +48,125 @@ struct InitContextOptions {
   std::vector<const char*> required_layers{};
   std::vector<const char*> desired_layers{};
   bool enable_validation{false};
+  // Severity / type filtering, per message id rate limiting and asynchronous logging of
+  // validation messages (see 'DebugMessageSink')
+  DebugMessageFilter debug_filter{};
+
+  // Perf lint: enables validation with the VK_EXT_validation_features best-practices checks
+  // and aggregates performance warnings by message id & object into
+  // 'VkContext::debugger->sink().perf_report()'.  The JSON report is written to
+  // 'perf_lint_report_path' (if set) when the context is destroyed.
+  bool perf_lint{false};
+  std::filesystem::path perf_lint_report_path{};
 
   // Device
   std::vector<const char*> required_device_ext{};
   std::vector<const char*> desired_device_ext{};
 
+  // Enable dynamic rendering when available (Vulkan 1.3, or VK_KHR_dynamic_rendering with an
+  // api_version of at least 1.2).  See 'RenderingInfo'.
+  bool dynamic_rendering{true};
+
+  // Enable timeline semaphores when available (Vulkan 1.2, or VK_KHR_timeline_semaphore with
+  // an api_version of at least 1.1).  A 'QueueTimeline' is created for every queue.
+  bool timeline_semaphores{true};
+
+  // Enable VK_EXT_memory_budget (and VMA's budget support) when available.  It requires an
+  // api_version of at least 1.1; otherwise budgets are VMA estimates.
+  bool memory_budget{true};
+  // Heap usage / budget ratios at which 'MemoryBudget' pressure callbacks fire
+  std::vector<float> memory_pressure_thresholds{0.75f, 0.9f};
+
+  // Extensions & features requested for the VMA allocator
+  AllocatorOptions allocator{};
+
+  // Pipeline cache file.  When empty, the pipeline cache is kept in memory only.
+  std::filesystem::path pipeline_cache_path{};
+
+  // Queue family selection for the default physical device criteria
+  QueueTopologyPolicy queue_policy{QueueTopologyPolicy::PreferDedicated};
+
+  // Queues requested per family (one priority per queue, 0.0 - 1.0).  Families without an
+  // entry get a single queue with priority 1.0.  Requests are clamped to the number of queues
+  // the family exposes; requests past that limit share existing queues.
+  std::unordered_map<VkShared::Enums::QueueFamily, std::vector<float>> queue_priorities{};
+
+  // Ranking & requirements for the default physical device criteria.  Software rasterizers
+  // are only selected when 'device_policy.allow_software_rasterizer' is set.
+  DeviceSelectionPolicy device_policy{};
+
   // User defined physical device criteria.
   std::unique_ptr<PhysicalDevice> phy_device_criteria{};
 
   // User defined surfaces creation (SDL, GLFW, etc.); Multiple surfaces can be drawn to:
   std::vector<std::unique_ptr<SurfaceLoader>> surface_loaders;
+
+  // Offscreen render target rings.  These share the surface id namespace and the
+  // 'begin_frame' / 'end_frame' API, but are never presented.
+  std::vector<OffscreenTargetOptions> offscreen_targets{};
+
+  // Number of frames the CPU can record ahead of the GPU (per surface)
+  uint32_t frames_in_flight{2};
 };
 
 class InitContext {
  public:
   explicit InitContext(InitContextOptions options);
+  ~InitContext();
+
+  InitContext(const InitContext& source) = delete;
+  InitContext& operator=(const InitContext& rhs) = delete;
+  InitContext(InitContext&& source) noexcept = default;
+  InitContext& operator=(InitContext&& rhs) noexcept = default;
+
   [[nodiscard]] VkContext& context();
+
+  // Wall time of each initialization stage and its sub-spans (see 'StartupProfiler')
+  [[nodiscard]] const StartupProfiler& startup_profile() const;
+
+  // Rebuilds every surface's swapchain.  Returns false if every surface has a zero extent.
   [[nodiscard]] bool remake_swapchain();
+  // Rebuilds only the named surface's swapchain.  Returns false if its extent is zero.
+  [[nodiscard]] bool remake_swapchain(const std::string& id);
+
+  // Waits for the surface's next frame slot and acquires a swapchain image (or the next
+  // offscreen image).  Returns an empty optional when the swapchain is out of date (it is
+  // remade) or has no extent.
+  [[nodiscard]] std::optional<FrameInfo> begin_frame(const std::string& id);
+
+  // Submits the command buffers to the graphics queue and presents the acquired image
+  // (offscreen images are only submitted).  Additional binary semaphores can be signaled by
+  // the submission (e.g. 'FrameReadback::render_semaphore').  Returns false if the swapchain
+  // had to be remade; the submission was still made whenever this returns.
+  bool end_frame(const std::string& id, const std::vector<VkCommandBuffer>& cmd_buffers,
+                 const std::vector<VkSemaphore>& signal_semaphores = {});
 
  private:
   void init();
+  void profile_stage(const char* name, void (InitContext::*stage)());
   void init_instance();
   void init_physical_device();
   void init_logical_device();
   void init_queue_handles();
   void init_surfaces();
   void init_swapchain();
+  bool make_swapchain(const std::string& id, VkSwapchainContext& swap_ctx);
   void init_presentation();
+  void init_frames();
   void init_vma();
+  void init_offscreen();
+  void init_pipeline_cache();
+  void init_optional_features();
+  void init_timelines();
+  [[nodiscard]] PFN_vkVoidFunction device_function(const char* core_name, const char* khr_name) const;
+  void add_device_ext(std::vector<const char*>& extensions, const char* ext) const;
+  void request_device_ext(CapabilityRequest request, const char* ext);
+  void init_renderpass_cache();
+  void init_framebuffer_cache();
+  void init_deletion_queue();
 
   // Extension
-  [[nodiscard]] static std::vector<VkExtensionProperties> ext_properties();
+  [[nodiscard]] static std::vector<VkExtensionProperties> ext_properties(const char* layer = nullptr);
   [[nodiscard]] std::vector<const char*> ext_to_load(const std::vector<VkExtensionProperties>& supported_ext) const;
   [[nodiscard]] static bool ext_supported(const std::vector<VkExtensionProperties>& supported,
                                           const char* value_to_check);
@@ -62,10 +182,27 @@ class InitContext {
                                    std::vector<const char*>& layers,
                                    const std::vector<VkLayerProperties>& supported_layers);
 
-  [[nodiscard]] inline std::vector<uint32_t> unique_queues() const;
+  [[nodiscard]] inline std::vector<uint32_t> unique_queues(const VkSwapchainContext& swap_ctx) const;
+  void init_image_sync(VkSwapchainContext& swap_ctx) const;
+  void begin_context_frame(const std::string& id);
+  void submit_graphics(const std::vector<VkCommandBuffer>& cmd_buffers, const std::vector<SemaphoreWait>& waits,
+                       const std::vector<VkSemaphore>& signal_semaphores, VkFence fence) const;
 
   InitContextOptions m_opt;
   VkContext m_ctx;
+  StartupProfiler m_profiler{};
+
+  // Queue index (within its family) and priority assigned to each requested queue
+  std::unordered_map<VkShared::Enums::QueueFamily, std::vector<std::pair<uint32_t, float>>> m_queue_slots{};
+
+  // Passed to 'vmaSetCurrentFrameIndex'.  Advances once per frame across every surface (see
+  // 'begin_context_frame').
+  uint32_t m_frame_counter{0};
+  // Surfaces that began a frame since 'm_frame_counter' last advanced
+  std::unordered_set<std::string> m_frame_surfaces{};
+
+  // VK_EXT_validation_features is enabled (see 'InitContextOptions::perf_lint')
+  bool m_best_practices{false};
 };
 
 }  // namespace VkStartup
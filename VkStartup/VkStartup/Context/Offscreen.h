@@ -0,0 +1,28 @@
+#pragma once
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <string>
+#include <vector>
+
+namespace VkStartup {
+
+// Offscreen render target ring ("virtual swapchain").  Images are acquired and released
+// through 'begin_frame' / 'end_frame' exactly like a surface, minus presentation.
+struct OffscreenTargetOptions {
+  std::string id{};
+  VkExtent2D extent = {};
+  VkFormat format{VK_FORMAT_R8G8B8A8_UNORM};
+  uint32_t image_count{3};
+  VkImageUsageFlags usage_flags{VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+  bool depth{false};
+};
+
+// VMA backed images for an offscreen target.  Color image handles and views are exposed
+// through 'RenderpassBuffers' like swapchain images.
+struct OffscreenImages {
+  std::vector<VmaImageHandle> color_images{};
+  std::vector<VmaImageHandle> depth_images{};
+  std::vector<VkImageViewHandle> depth_views{};
+};
+
+}  // namespace VkStartup
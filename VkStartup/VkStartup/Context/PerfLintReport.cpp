@@ -0,0 +1,93 @@
+#include "VkStartup/Context/PerfLintReport.h"
+#include "VkStartup/Misc/Json.h"
+#include <algorithm>
+#include <fstream>
+#include <ranges>
+#include <set>
+#include <sstream>
+
+namespace VkStartup {
+
+void PerfLintReport::record(const VkDebugUtilsMessengerCallbackDataEXT& data) {
+  const VkDebugUtilsObjectNameInfoEXT* object = data.objectCount > 0 ? &data.pObjects[0] : nullptr;
+  const Key key{data.messageIdNumber, object ? object->objectHandle : 0};
+
+  const std::lock_guard lock{m_mutex};
+  m_total++;
+  auto [it, inserted] = m_entries.try_emplace(key);
+  auto& entry = it->second;
+  entry.count++;
+  if (inserted) {
+    entry.id = data.messageIdNumber;
+    entry.id_name = data.pMessageIdName ? data.pMessageIdName : "";
+    entry.message = data.pMessage ? data.pMessage : "";
+    if (object) {
+      entry.object_type = object->objectType;
+      entry.object_handle = object->objectHandle;
+      entry.object_name = object->pObjectName ? object->pObjectName : "";
+    }
+  }
+}
+
+std::vector<PerfLintEntry> PerfLintReport::entries() const {
+  std::vector<PerfLintEntry> result{};
+  {
+    const std::lock_guard lock{m_mutex};
+    result.reserve(m_entries.size());
+    for (const auto& entry : m_entries | std::views::values) {
+      result.push_back(entry);
+    }
+  }
+  std::ranges::stable_sort(result, [](const auto& lhs, const auto& rhs) { return lhs.count > rhs.count; });
+  return result;
+}
+
+std::vector<std::string> PerfLintReport::message_ids() const {
+  std::set<std::string> ids{};
+  {
+    const std::lock_guard lock{m_mutex};
+    for (const auto& entry : m_entries | std::views::values) {
+      ids.insert(entry.id_name.empty() ? std::to_string(entry.id) : entry.id_name);
+    }
+  }
+  return {ids.begin(), ids.end()};
+}
+
+uint64_t PerfLintReport::total() const {
+  const std::lock_guard lock{m_mutex};
+  return m_total;
+}
+
+bool PerfLintReport::empty() const {
+  const std::lock_guard lock{m_mutex};
+  return m_entries.empty();
+}
+
+std::string PerfLintReport::json() const {
+  const auto all = entries();
+  std::ostringstream stream{};
+  stream << "{\n  \"total\": " << total() << ",\n  \"message_ids\": [";
+  const auto ids = message_ids();
+  for (size_t i = 0; i < ids.size(); i++) {
+    stream << (i == 0 ? "" : ", ") << "\"" << Json::escape(ids[i]) << "\"";
+  }
+  stream << "],\n  \"entries\": [";
+  for (size_t i = 0; i < all.size(); i++) {
+    const auto& entry = all[i];
+    stream << (i == 0 ? "\n" : ",\n") << "    {\"id\": " << entry.id << ", \"id_name\": \""
+           << Json::escape(entry.id_name) << "\", \"object_type\": " << entry.object_type
+           << ", \"object_handle\": " << entry.object_handle << ", \"object_name\": \""
+           << Json::escape(entry.object_name) << "\", \"count\": " << entry.count << ", \"message\": \""
+           << Json::escape(entry.message) << "\"}";
+  }
+  stream << (all.empty() ? "]\n}\n" : "\n  ]\n}\n");
+  return stream.str();
+}
+
+bool PerfLintReport::write_json(const std::filesystem::path& path) const {
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  file << json();
+  return static_cast<bool>(file);
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,50 @@
+#pragma once
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace VkStartup {
+
+struct PerfLintEntry {
+  int32_t id{0};
+  std::string id_name{};
+  // First object of the message (VK_OBJECT_TYPE_UNKNOWN & 0 when the message has none)
+  VkObjectType object_type{VK_OBJECT_TYPE_UNKNOWN};
+  uint64_t object_handle{0};
+  std::string object_name{};
+  uint64_t count{0};
+  // Text of the first occurrence
+  std::string message{};
+};
+
+// Performance warnings (VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT, e.g. from the
+// best-practices layer checks) aggregated by message id and object handle.  Recording takes a
+// lock, so the report is meant for lint runs rather than shipping builds.
+class PerfLintReport {
+ public:
+  void record(const VkDebugUtilsMessengerCallbackDataEXT& data);
+
+  // Most frequent first
+  [[nodiscard]] std::vector<PerfLintEntry> entries() const;
+  // Distinct message ids (e.g. to compare against a baseline of accepted warnings)
+  [[nodiscard]] std::vector<std::string> message_ids() const;
+  // Messages recorded, counting repeats
+  [[nodiscard]] uint64_t total() const;
+  [[nodiscard]] bool empty() const;
+
+  [[nodiscard]] std::string json() const;
+  bool write_json(const std::filesystem::path& path) const;
+
+ private:
+  using Key = std::pair<int32_t, uint64_t>;
+  mutable std::mutex m_mutex{};
+  std::map<Key, PerfLintEntry> m_entries{};
+  uint64_t m_total{0};
+};
+
+}  // namespace VkStartup
@@ -1,9 +1,14 @@
 #include "VkStartup/Context/PhysicalDevice.h"
 #include "VkStartup/Misc/Exceptions.h"
+#include "VkStartup/Misc/Profiler.h"
 #include "VkShared/Macros.h"
 #include <vector>
 #include <map>
 #include <cstring>
+#include <optional>
+#include <algorithm>
+#include <string>
+#include <utility>
 
 namespace VkStartup {
 
@@ -23,16 +28,51 @@ PhysicalDeviceInfo PhysicalDevice::info() {
   info.vk_queue_family_indices = m_queue_indices;
   info.features_to_activate = m_device_features_to_activate;
   info.device_ext = device_ext_to_use(m_vk_physical_device);
+  info.api_version = std::min(m_device_properties.apiVersion, m_instance_api_version);
+  info.supported_features = m_supported_features;
+  info.feature_chain_to_activate = m_feature_chain_to_activate;
+
+  // Requested extended features must be supported.  Extensions are added for structs
+  // that aren't core in the api version.
+  const auto unsupported = m_feature_chain_to_activate.unsupported(m_supported_features);
+  if (!unsupported.empty()) {
+    for (const auto& name : unsupported) {
+      VkError("Requested features in " + name + " are not supported by the selected device");
+    }
+    throw Exceptions::VkStartupException();
+  }
+  for (const auto ext : m_feature_chain_to_activate.required_extensions(info.api_version)) {
+    if (std::ranges::none_of(info.device_ext, [ext](const char* value) { return strcmp(value, ext) == 0; })) {
+      info.device_ext.push_back(ext);
+    }
+  }
   info.depth_format = m_depth_format;
   info.depth_format_supports_stencil = m_depth_supports_stencil;
+  info.queue_family_properties = m_queue_families;
+  info.queue_topology = m_queue_topology;
+  info.memory_topology = m_memory_topology;
   return info;
 }
 
+void PhysicalDevice::queue_topology_policy(const QueueTopologyPolicy policy) {
+  m_queue_policy = policy;
+}
+
+void PhysicalDevice::api_version(const uint32_t api_version) {
+  m_instance_api_version = api_version;
+}
+
 void PhysicalDevice::select_physical_device() {
   // Use user defined physical device selection.  If not defined, the default
   // selection will be used
-  const auto devices = physical_devices();
-  select_best_physical_device(devices);
+  const auto devices = [this] {
+    const ProfileScope scope{"physical device enumeration"};
+    return physical_devices();
+  }();
+  {
+    const ProfileScope scope{"device selection"};
+    select_best_physical_device(devices);
+  }
   if (!m_vk_physical_device) {
     VkError("Failed to select a physical device based on criteria");
     throw Exceptions::VkStartupException();
@@ -43,14 +83,27 @@ void PhysicalDevice::select_physical_device() {
   // Store properties of best selected physical device
   vkGetPhysicalDeviceProperties(m_vk_physical_device, &m_device_properties);
 
+  // Store supported extended features
+  {
+    const ProfileScope scope{"feature query"};
+    m_supported_features = query_features(m_vk_physical_device);
+  }
+
   // Store features to activate later
   set_features_to_activate();
+  set_feature_chain_to_activate();
 
   // Store depth format
   set_depth_format();
 
   // Set queue indices
   set_queue_indices();
+
+  // Store memory topology
+  m_memory_topology = memory_topology(m_vk_physical_device);
+  VkInfo(std::string{"Host visible device local memory: "} +
+         std::to_string(m_memory_topology.host_visible_device_local_size >> 20) + " MiB" +
+         (m_memory_topology.unified ? " (unified)" : m_memory_topology.resizable_bar ? " (resizable BAR)" : ""));
 }
 
 void PhysicalDevice::display_physical_device() const {
@@ -80,36 +133,64 @@ void PhysicalDevice::set_queue_indices() {
   uint32_t queue_family_count = 0;
   vkGetPhysicalDeviceQueueFamilyProperties(m_vk_physical_device, &queue_family_count, nullptr);
 
-  std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
-  vkGetPhysicalDeviceQueueFamilyProperties(m_vk_physical_device, &queue_family_count, queue_families.data());
+  m_queue_families.resize(queue_family_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(m_vk_physical_device, &queue_family_count, m_queue_families.data());
 
-  int i = 0;
-  for (const auto& family : queue_families) {
-    if (family.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-      if (!m_queue_indices.contains(QueueFamily::Graphics)) {
-        m_queue_indices[QueueFamily::Graphics] = i;
-      }
-    }
-    if (family.queueFlags & VK_QUEUE_TRANSFER_BIT) {
-      if (!m_queue_indices.contains(QueueFamily::Transfer)) {
-        m_queue_indices[QueueFamily::Transfer] = i;
-      }
-    }
-    if (family.queueFlags & VK_QUEUE_COMPUTE_BIT) {
-      if (!m_queue_indices.contains(QueueFamily::Compute)) {
-        m_queue_indices[QueueFamily::Compute] = i;
+  // First family containing all 'required' flags and none of the 'excluded' flags
+  const auto find_family = [this](const VkQueueFlags required, const VkQueueFlags excluded) -> std::optional<uint32_t> {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_queue_families.size()); i++) {
+      const auto& [flags, count, timestamp_bits, granularity] = m_queue_families[i];
+      if (count > 0 && (flags & required) == required && !(flags & excluded)) {
+        return i;
       }
     }
-    i++;
+    return std::nullopt;
+  };
+
+  const bool prefer_dedicated = m_queue_policy == QueueTopologyPolicy::PreferDedicated;
+  m_queue_indices.clear();
+  m_queue_topology = {};
+
+  // Graphics
+  const auto graphics = find_family(VK_QUEUE_GRAPHICS_BIT, 0);
+  if (graphics) {
+    m_queue_indices[QueueFamily::Graphics] = *graphics;
   }
 
-  // If no transfer queue exists, use graphics queue
-  if (!m_queue_indices.contains(QueueFamily::Transfer)) {
-    if (m_queue_indices.contains(QueueFamily::Graphics)) {
-      m_queue_indices[QueueFamily::Transfer] = m_queue_indices[QueueFamily::Graphics];
-    }
-    m_queue_indices[QueueFamily::Transfer] = i;
+  // Compute (async compute families have no graphics support)
+  std::optional<uint32_t> compute;
+  if (prefer_dedicated) {
+    compute = find_family(VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+    m_queue_topology.dedicated_compute = compute.has_value();
+  }
+  if (!compute) {
+    compute = find_family(VK_QUEUE_COMPUTE_BIT, 0);
+  }
+  if (compute) {
+    m_queue_indices[QueueFamily::Compute] = *compute;
   }
+
+  // Transfer (DMA families have neither graphics nor compute support)
+  std::optional<uint32_t> transfer;
+  if (prefer_dedicated) {
+    transfer = find_family(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+    m_queue_topology.dedicated_transfer = transfer.has_value();
+  }
+  if (!transfer) {
+    transfer = find_family(VK_QUEUE_TRANSFER_BIT, 0);
+  }
+
+  // Graphics and compute families support transfer operations even when the
+  // transfer bit isn't reported
+  if (!transfer) {
+    transfer = graphics ? graphics : compute;
+  }
+  if (transfer) {
+    m_queue_indices[QueueFamily::Transfer] = *transfer;
+  }
+
+  VkInfo(std::string{"Dedicated transfer queue family: "} + (m_queue_topology.dedicated_transfer ? "yes" : "no") +
+         ", dedicated compute queue family: " + (m_queue_topology.dedicated_compute ? "yes" : "no"));
 }
 
 bool PhysicalDevice::ext_supported(const std::vector<VkExtensionProperties>& supported, const char* value_to_check) {
@@ -121,7 +202,67 @@ bool PhysicalDevice::ext_supported(const std::vector<VkExtensionProperties>& sup
   return false;
 }
 
+uint32_t PhysicalDevice::device_api_version(VkPhysicalDevice device) const {
+  VkPhysicalDeviceProperties properties = {};
+  vkGetPhysicalDeviceProperties(device, &properties);
+  return std::min(properties.apiVersion, m_instance_api_version);
+}
+
+FeatureChain PhysicalDevice::query_features(VkPhysicalDevice device) const {
+  return FeatureChain::query(m_vk_instance, device, device_api_version(device));
+}
+
+uint32_t PhysicalDevice::subgroup_size(VkPhysicalDevice device) const {
+  if (device_api_version(device) < VK_API_VERSION_1_1) {
+    return 0;
+  }
+  const auto get_properties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2>(
+      vkGetInstanceProcAddr(m_vk_instance, "vkGetPhysicalDeviceProperties2"));
+  if (!get_properties2) {
+    return 0;
+  }
+
+  VkPhysicalDeviceSubgroupProperties subgroup = {};
+  subgroup.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+  VkPhysicalDeviceProperties2 properties = {};
+  properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties.pNext = &subgroup;
+  get_properties2(device, &properties);
+  return subgroup.subgroupSize;
+}
+
+MemoryTopology PhysicalDevice::memory_topology(VkPhysicalDevice device) {
+  VkPhysicalDeviceMemoryProperties properties = {};
+  vkGetPhysicalDeviceMemoryProperties(device, &properties);
+
+  // Device local heaps & whether they expose a host visible memory type
+  std::map<uint32_t, bool> device_local_heaps{};
+  for (uint32_t i = 0; i < properties.memoryTypeCount; i++) {
+    const auto& [flags, heap_index] = properties.memoryTypes[i];
+    if (!(flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+      continue;
+    }
+    auto& host_visible = device_local_heaps[heap_index];
+    host_visible = host_visible || (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+  }
+
+  MemoryTopology topology{};
+  topology.unified = !device_local_heaps.empty();
+  for (const auto& [heap_index, host_visible] : device_local_heaps) {
+    topology.unified = topology.unified && host_visible;
+    if (host_visible) {
+      topology.host_visible_device_local_size =
+          std::max(topology.host_visible_device_local_size, properties.memoryHeaps[heap_index].size);
+    }
+  }
+  // Without resizable BAR only a 256 MiB window of VRAM is host visible
+  constexpr VkDeviceSize bar_window{256ull << 20};
+  topology.resizable_bar = !topology.unified && topology.host_visible_device_local_size > bar_window;
+  return topology;
+}
+
 std::vector<const char*> PhysicalDevice::device_ext_to_use(VkPhysicalDevice device) const {
+  const ProfileScope scope{"device extension check"};
   // Check extensions
   uint32_t extension_count{0};
   vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
@@ -156,30 +297,15 @@ PhysicalDeviceDefault::PhysicalDeviceDefault(VkInstance instance, std::vector<co
     : PhysicalDevice{instance, std::move(desired_device_ext), std::move(required_device_ext)} {
 }
 
-void PhysicalDeviceDefault::select_best_physical_device(const std::vector<VkPhysicalDevice>& devices) {
-  std::multimap<int, VkPhysicalDevice> candidates;
+void PhysicalDeviceDefault::selection_policy(DeviceSelectionPolicy policy) {
+  m_policy = std::move(policy);
+}
 
+void PhysicalDeviceDefault::select_best_physical_device(const std::vector<VkPhysicalDevice>& devices) {
+  std::multimap<double, VkPhysicalDevice> candidates;
   for (const auto& device : devices) {
-    VkPhysicalDeviceProperties properties = {};
-    vkGetPhysicalDeviceProperties(device, &properties);
-
-    VkPhysicalDeviceFeatures features = {};
-    vkGetPhysicalDeviceFeatures(device, &features);
-
-    // Rank devices
-    int score = 0;
-    if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-      score += 1000;
-    }
-
-    // Drop llvmpipe
-    if (strstr(properties.deviceName, "llvmpipe")) {
-      score -= 100000;
-    }
-
-    score += static_cast<int>(properties.limits.maxImageDimension2D);
-    if (device_meets_requirements(device, features)) {
-      candidates.insert(std::make_pair(score, device));
+    if (const auto device_score = score(device)) {
+      candidates.insert(std::make_pair(*device_score, device));
     }
   }
 
@@ -188,32 +314,112 @@ void PhysicalDeviceDefault::select_best_physical_device(const std::vector<VkPhys
   }
 }
 
-bool PhysicalDeviceDefault::device_meets_requirements(VkPhysicalDevice device,
-                                                      const VkPhysicalDeviceFeatures& device_features) {
+std::optional<double> PhysicalDeviceDefault::score(VkPhysicalDevice device) const {
+  VkPhysicalDeviceProperties properties = {};
+  vkGetPhysicalDeviceProperties(device, &properties);
+  const std::string name{properties.deviceName};
+  const ProfileScope scope{"score: " + name};
+
+  if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU && !m_policy.allow_software_rasterizer) {
+    VkInfo("Skipping software rasterizer " + name + " (DeviceSelectionPolicy::allow_software_rasterizer)");
+    return std::nullopt;
+  }
+  if (!has_graphics_queue(device)) {
+    VkInfo("Skipping " + name + ": no graphics queue family");
+    return std::nullopt;
+  }
+  const auto supported = query_features(device);
+  if (const auto missing = m_policy.required_features.unsupported(supported); !missing.empty()) {
+    VkInfo("Skipping " + name + ": required features in " + missing.front() + " are not supported");
+    return std::nullopt;
+  }
+
+  double device_score{0.0};
+  switch (properties.deviceType) {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+      device_score += m_policy.discrete_gpu_weight;
+      break;
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+      device_score += m_policy.integrated_gpu_weight;
+      break;
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+      device_score += m_policy.virtual_gpu_weight;
+      break;
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:
+      device_score += m_policy.cpu_weight;
+      break;
+    default:
+      break;
+  }
+
+  constexpr double gib{1024.0 * 1024.0 * 1024.0};
+  device_score += m_policy.device_local_gib_weight * static_cast<double>(device_local_heap_size(device)) / gib;
+
+  const auto topology = dedicated_queue_families(device);
+  device_score += topology.dedicated_transfer ? m_policy.dedicated_transfer_weight : 0.0;
+  device_score += topology.dedicated_compute ? m_policy.dedicated_compute_weight : 0.0;
+
+  device_score += m_policy.subgroup_size_weight * subgroup_size(device);
+  device_score += m_policy.desired_feature_weight * m_policy.desired_features.intersect(supported).count();
+
+  VkInfo("Physical device " + name + " score: " + std::to_string(device_score));
+  return device_score;
+}
+
+bool PhysicalDeviceDefault::has_graphics_queue(VkPhysicalDevice device) {
   uint32_t queue_family_count = 0;
   vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, nullptr);
 
   std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
   vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, queue_families.data());
 
-  bool meets_queue_critiera{false};
-  for (const auto& queueFamily : queue_families) {
-    if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-      meets_queue_critiera = true;
-      break;
+  return std::ranges::any_of(queue_families, [](const VkQueueFamilyProperties& family) {
+    return family.queueCount > 0 && (family.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+  });
+}
+
+VkDeviceSize PhysicalDeviceDefault::device_local_heap_size(VkPhysicalDevice device) {
+  VkPhysicalDeviceMemoryProperties memory = {};
+  vkGetPhysicalDeviceMemoryProperties(device, &memory);
+
+  VkDeviceSize largest{0};
+  for (uint32_t i = 0; i < memory.memoryHeapCount; i++) {
+    if (memory.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+      largest = std::max(largest, memory.memoryHeaps[i].size);
     }
   }
+  return largest;
+}
 
-  bool meets_feature_criteria{false};
-  if (device_features.geometryShader) {
-    meets_feature_criteria = true;
-  }
+QueueTopology PhysicalDeviceDefault::dedicated_queue_families(VkPhysicalDevice device) {
+  uint32_t queue_family_count = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, nullptr);
+
+  std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+  vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_family_count, queue_families.data());
 
-  return meets_queue_critiera && meets_feature_criteria;
+  QueueTopology topology{};
+  for (const auto& [flags, count, timestamp_bits, granularity] : queue_families) {
+    if (count == 0 || (flags & VK_QUEUE_GRAPHICS_BIT)) {
+      continue;
+    }
+    if (flags & VK_QUEUE_COMPUTE_BIT) {
+      topology.dedicated_compute = true;
+    } else if (flags & VK_QUEUE_TRANSFER_BIT) {
+      topology.dedicated_transfer = true;
+    }
+  }
+  return topology;
 }
 
 void PhysicalDeviceDefault::set_features_to_activate() {
-  m_device_features_to_activate.geometryShader = VK_TRUE;
+  m_enabled_features = m_policy.desired_features.intersect(m_supported_features);
+  m_enabled_features.merge(m_policy.required_features);
+  m_device_features_to_activate = m_enabled_features.features2.features;
+}
+
+void PhysicalDeviceDefault::set_feature_chain_to_activate() {
+  m_feature_chain_to_activate = m_enabled_features;
 }
 
 void PhysicalDeviceDefault::set_depth_format() {
@@ -1,11 +1,73 @@
 #pragma once
 #include "VkStartup/Handle/UsingHandle.h"
+#include "VkStartup/Context/FeatureChain.h"
 #include <VkShared/Enums.h>
+#include <optional>
 #include <vector>
 #include <unordered_map>
 
 namespace VkStartup {
 
+enum class QueueTopologyPolicy {
+  // First family supporting each capability (transfer & compute usually share the graphics family)
+  Shared,
+  // Transfer-only and compute-only families are used when the device exposes them
+  PreferDedicated
+};
+
+struct QueueTopology {
+  bool dedicated_transfer{false};
+  bool dedicated_compute{false};
+};
+
+struct MemoryTopology {
+  // Largest heap with a DEVICE_LOCAL | HOST_VISIBLE memory type (0 when there is none)
+  VkDeviceSize host_visible_device_local_size{0};
+  // Every device local heap is host visible (integrated GPUs / unified memory)
+  bool unified{false};
+  // Host visible device local memory beyond the legacy 256 MiB BAR window (resizable BAR / SAM)
+  bool resizable_bar{false};
+
+  // The CPU can write device local memory directly instead of through a staging copy
+  [[nodiscard]] bool direct_upload() const {
+    return unified || resizable_bar;
+  }
+};
+
+// Data-driven ranking used by 'PhysicalDeviceDefault'.  Devices missing a graphics queue or a
+// required feature are rejected; the remaining devices are ranked by the weighted sum of
+// their capabilities and the highest score is selected.
+struct DeviceSelectionPolicy {
+  // CPU devices (lavapipe / llvmpipe, SwiftShader) are skipped unless enabled.  When
+  // enabled they still rank below any hardware device with the default weights.
+  bool allow_software_rasterizer{false};
+
+  // Rejected when unsupported.  Always enabled on the logical device.
+  FeatureChain required_features{};
+  // Enabled when supported; each supported feature adds 'desired_feature_weight'
+  FeatureChain desired_features{default_desired_features()};
+
+  // Device type
+  double discrete_gpu_weight{10000.0};
+  double integrated_gpu_weight{5000.0};
+  double virtual_gpu_weight{2000.0};
+  double cpu_weight{0.0};
+  // Per GiB of the largest device local heap
+  double device_local_gib_weight{100.0};
+  // Transfer-only and compute-only queue families
+  double dedicated_transfer_weight{250.0};
+  double dedicated_compute_weight{250.0};
+  // Per subgroup lane (requires api version 1.1)
+  double subgroup_size_weight{4.0};
+  double desired_feature_weight{10.0};
+
+  [[nodiscard]] static FeatureChain default_desired_features() {
+    FeatureChain features{};
+    features.features2.features.geometryShader = VK_TRUE;
+    return features;
+  }
+};
+
 struct PhysicalDeviceInfo {
   VkPhysicalDevice vk_phy_device{VK_NULL_HANDLE};
   std::unordered_map<VkShared::Enums::QueueFamily, uint32_t> vk_queue_family_indices{};
@@ -13,6 +75,27 @@ struct PhysicalDeviceInfo {
   std::vector<const char*> device_ext = {};
   VkFormat depth_format{VK_FORMAT_UNDEFINED};
   bool depth_format_supports_stencil{false};
+  std::vector<VkQueueFamilyProperties> queue_family_properties{};
+  QueueTopology queue_topology{};
+  MemoryTopology memory_topology{};
+  // Device api version limited to the instance api version
+  uint32_t api_version{VK_API_VERSION_1_0};
+  // Extended features.  'features_to_activate' is copied into 'features2.features' when the
+  // chain is passed to vkCreateDevice.
+  FeatureChain supported_features{};
+  FeatureChain feature_chain_to_activate{};
+  // Enabled at device creation when the device supports it (see 'InitContextOptions')
+  bool dynamic_rendering{false};
+  bool timeline_semaphore{false};
+  // VK_EXT_memory_budget is enabled (see 'InitContextOptions::memory_budget')
+  bool memory_budget{false};
+  // Allocator capabilities enabled on the device (see 'InitContextOptions::allocator').  The
+  // VMA allocator flags are derived from these.
+  bool dedicated_allocation{false};
+  bool bind_memory2{false};
+  bool buffer_device_address{false};
+  bool memory_priority{false};
+  bool device_coherent_memory{false};
 };
 
 class PhysicalDevice {
@@ -27,14 +110,28 @@ class PhysicalDevice {
   PhysicalDevice& operator=(PhysicalDevice&& rhs) noexcept = default;
 
   [[nodiscard]] PhysicalDeviceInfo info();
+  void queue_topology_policy(QueueTopologyPolicy policy);
+  // Api version the instance was created with.  Extended features are only queried and
+  // chained for 1.1 and newer.
+  void api_version(uint32_t api_version);
 
  protected:
   [[nodiscard]] static bool ext_supported(const std::vector<VkExtensionProperties>& supported,
                                           const char* value_to_check);
   [[nodiscard]] std::vector<const char*> device_ext_to_use(VkPhysicalDevice device) const;
+  // Device api version limited to the instance api version
+  [[nodiscard]] uint32_t device_api_version(VkPhysicalDevice device) const;
+  // Supported features of a candidate device (see 'FeatureChain::query')
+  [[nodiscard]] FeatureChain query_features(VkPhysicalDevice device) const;
+  // Zero if VkPhysicalDeviceSubgroupProperties can't be queried (api version 1.0)
+  [[nodiscard]] uint32_t subgroup_size(VkPhysicalDevice device) const;
+  [[nodiscard]] static MemoryTopology memory_topology(VkPhysicalDevice device);
 
   VkPhysicalDevice m_vk_physical_device{VK_NULL_HANDLE};
   VkPhysicalDeviceFeatures m_device_features_to_activate = {};
+  // Filled before 'set_feature_chain_to_activate' is called
+  FeatureChain m_supported_features{};
+  FeatureChain m_feature_chain_to_activate{};
   VkFormat m_depth_format{VK_FORMAT_UNDEFINED};
   bool m_depth_supports_stencil{false};
 
@@ -45,6 +142,10 @@ class PhysicalDevice {
   virtual void select_best_physical_device(const std::vector<VkPhysicalDevice>& devices) = 0;
   virtual void set_features_to_activate() = 0;
   virtual void set_depth_format() = 0;
+  // Optional.  Request extended features in 'm_feature_chain_to_activate'.  Extensions for
+  // non-core structs are enabled automatically.
+  virtual void set_feature_chain_to_activate() {
+  }
 
   void select_physical_device();
   void set_queue_indices();
@@ -52,10 +153,15 @@ class PhysicalDevice {
   void display_physical_device() const;
 
   VkInstance m_vk_instance{VK_NULL_HANDLE};
+  uint32_t m_instance_api_version{VK_API_VERSION_1_0};
 
   // Selected device
   VkPhysicalDeviceProperties m_device_properties = {};
   std::unordered_map<VkShared::Enums::QueueFamily, uint32_t> m_queue_indices;
+  std::vector<VkQueueFamilyProperties> m_queue_families{};
+  QueueTopologyPolicy m_queue_policy{QueueTopologyPolicy::PreferDedicated};
+  QueueTopology m_queue_topology{};
+  MemoryTopology m_memory_topology{};
 };
 
 // Default implementation of selecting physical device.  This can
@@ -65,12 +171,21 @@ class PhysicalDeviceDefault final : public PhysicalDevice {
   explicit PhysicalDeviceDefault(VkInstance instance, std::vector<const char*> desired_device_ext,
                                  std::vector<const char*> required_device_ext);
 
+  void selection_policy(DeviceSelectionPolicy policy);
+
  private:
   void select_best_physical_device(const std::vector<VkPhysicalDevice>& devices) override;
   void set_features_to_activate() override;
+  void set_feature_chain_to_activate() override;
   void set_depth_format() override;
-  [[nodiscard]] static bool device_meets_requirements(VkPhysicalDevice device,
-                                                      const VkPhysicalDeviceFeatures& device_features);
+  [[nodiscard]] std::optional<double> score(VkPhysicalDevice device) const;
+  [[nodiscard]] static bool has_graphics_queue(VkPhysicalDevice device);
+  [[nodiscard]] static VkDeviceSize device_local_heap_size(VkPhysicalDevice device);
+  [[nodiscard]] static QueueTopology dedicated_queue_families(VkPhysicalDevice device);
+
+  DeviceSelectionPolicy m_policy{};
+  // Union of the required features and the supported desired features
+  FeatureChain m_enabled_features{};
 };
 
 }  // namespace VkStartup
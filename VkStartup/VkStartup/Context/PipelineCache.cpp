@@ -0,0 +1,237 @@
+#include "VkStartup/Context/PipelineCache.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VkStartup {
+
+namespace {
+
+// Read-only memory mapping of the on-disk cache.  The mapping only needs to live until
+// vkCreatePipelineCache has consumed the initial data.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+    m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+      return;
+    }
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(m_file, &file_size) || file_size.QuadPart == 0) {
+      return;
+    }
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+      return;
+    }
+    m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_data) {
+      m_size = static_cast<size_t>(file_size.QuadPart);
+    }
+#else
+    m_fd = open(path.c_str(), O_RDONLY);
+    if (m_fd < 0) {
+      return;
+    }
+    struct stat file_stat = {};
+    if (fstat(m_fd, &file_stat) != 0 || file_stat.st_size == 0) {
+      return;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (data != MAP_FAILED) {
+      m_data = data;
+      m_size = static_cast<size_t>(file_stat.st_size);
+    }
+#endif
+  }
+
+  ~MappedFile() {
+#ifdef _WIN32
+    if (m_data) {
+      UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+      CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+      CloseHandle(m_file);
+    }
+#else
+    if (m_data) {
+      munmap(m_data, m_size);
+    }
+    if (m_fd >= 0) {
+      close(m_fd);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile& source) = delete;
+  MappedFile& operator=(const MappedFile& rhs) = delete;
+  MappedFile(MappedFile&& source) noexcept = delete;
+  MappedFile& operator=(MappedFile&& rhs) noexcept = delete;
+
+  [[nodiscard]] const void* data() const {
+    return m_data;
+  }
+
+  [[nodiscard]] size_t size() const {
+    return m_size;
+  }
+
+ private:
+#ifdef _WIN32
+  HANDLE m_file{INVALID_HANDLE_VALUE};
+  HANDLE m_mapping{nullptr};
+#else
+  int m_fd{-1};
+#endif
+  void* m_data{nullptr};
+  size_t m_size{0};
+};
+
+// Writes 'data' and flushes it to disk before returning, so a later rename can't expose a
+// truncated file after a crash
+bool write_file_durable(const std::filesystem::path& path, const char* data, const size_t size) {
+#ifdef _WIN32
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  bool written{true};
+  size_t offset{0};
+  while (written && offset < size) {
+    DWORD chunk{0};
+    const auto to_write = static_cast<DWORD>(std::min<size_t>(size - offset, 1u << 30));
+    written = WriteFile(file, data + offset, to_write, &chunk, nullptr) && chunk > 0;
+    offset += chunk;
+  }
+  written = written && FlushFileBuffers(file);
+  return CloseHandle(file) && written;
+#else
+  const int file = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (file < 0) {
+    return false;
+  }
+  bool written{true};
+  size_t offset{0};
+  while (written && offset < size) {
+    const ssize_t chunk = write(file, data + offset, size - offset);
+    written = chunk > 0;
+    offset += written ? static_cast<size_t>(chunk) : 0;
+  }
+  written = written && fsync(file) == 0;
+  return close(file) == 0 && written;
+#endif
+}
+
+}  // namespace
+
+PipelineCache::PipelineCache(VkDevice device, VkPhysicalDevice phy_device, std::filesystem::path path)
+    : m_vk_device{device}, m_path{std::move(path)} {
+  vkGetPhysicalDeviceProperties(phy_device, &m_device_properties);
+  init();
+}
+
+PipelineCache::~PipelineCache() {
+  save();
+}
+
+void PipelineCache::init() {
+  if (m_path.empty()) {
+    m_cache = VkPipelineCacheHandle{CreateInfo::vk_pipeline_cache_create_info(0, nullptr), m_vk_device};
+    return;
+  }
+
+  // Seed the cache straight from the mapped file; a stale or foreign cache is ignored
+  const MappedFile file{m_path};
+  if (file.data() && header_valid(file.data(), file.size())) {
+    m_cache = VkPipelineCacheHandle{CreateInfo::vk_pipeline_cache_create_info(file.size(), file.data()), m_vk_device};
+    VkInfo("Loaded pipeline cache: " + m_path.string());
+  } else {
+    if (file.data()) {
+      VkWarning("Pipeline cache does not match the selected device and will be rebuilt: " + m_path.string());
+    }
+    m_cache = VkPipelineCacheHandle{CreateInfo::vk_pipeline_cache_create_info(0, nullptr), m_vk_device};
+  }
+}
+
+bool PipelineCache::header_valid(const void* data, const size_t size) const {
+  VkPipelineCacheHeaderVersionOne header = {};
+  if (size < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  return header.headerSize >= sizeof(header) && header.headerSize <= size &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == m_device_properties.vendorID && header.deviceID == m_device_properties.deviceID &&
+         std::memcmp(header.pipelineCacheUUID, m_device_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+bool PipelineCache::save() const {
+  if (m_path.empty() || !m_cache()) {
+    return false;
+  }
+
+  size_t data_size{0};
+  if (vkGetPipelineCacheData(m_vk_device, m_cache(), &data_size, nullptr) != VK_SUCCESS || data_size == 0) {
+    return false;
+  }
+  std::vector<char> data(data_size);
+  if (vkGetPipelineCacheData(m_vk_device, m_cache(), &data_size, data.data()) != VK_SUCCESS) {
+    VkWarning("Unable to retrieve pipeline cache data");
+    return false;
+  }
+
+  std::error_code error;
+  if (m_path.has_parent_path()) {
+    std::filesystem::create_directories(m_path.parent_path(), error);
+  }
+
+  auto tmp_path = m_path;
+  tmp_path += ".tmp";
+  if (!write_file_durable(tmp_path, data.data(), data_size)) {
+    VkWarning("Unable to write pipeline cache: " + tmp_path.string());
+    std::filesystem::remove(tmp_path, error);
+    return false;
+  }
+
+  std::filesystem::rename(tmp_path, m_path, error);
+  if (error) {
+    VkWarning("Unable to replace pipeline cache: " + m_path.string() + " (" + error.message() + ")");
+    std::filesystem::remove(tmp_path, error);
+    return false;
+  }
+  return true;
+}
+
+VkPipelineCache PipelineCache::handle() const {
+  return m_cache();
+}
+
+const std::filesystem::path& PipelineCache::path() const {
+  return m_path;
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,38 @@
+#pragma once
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <filesystem>
+
+namespace VkStartup {
+
+// VkPipelineCache that is optionally persisted to disk.  If a path is supplied, the
+// cache is seeded from the file (when its header matches the selected device) and
+// written back when the cache is destroyed or 'save()' is called.
+class PipelineCache {
+ public:
+  explicit PipelineCache(VkDevice device, VkPhysicalDevice phy_device, std::filesystem::path path);
+  ~PipelineCache();
+
+  PipelineCache(const PipelineCache& source) = delete;
+  PipelineCache& operator=(const PipelineCache& rhs) = delete;
+  PipelineCache(PipelineCache&& source) noexcept = delete;
+  PipelineCache& operator=(PipelineCache&& rhs) noexcept = delete;
+
+  [[nodiscard]] VkPipelineCache handle() const;
+  [[nodiscard]] const std::filesystem::path& path() const;
+
+  // Write the current cache contents to disk.  The file is written to a temporary
+  // location and renamed so a crash never leaves a partially written cache behind.
+  bool save() const;
+
+ private:
+  void init();
+  [[nodiscard]] bool header_valid(const void* data, size_t size) const;
+
+  VkDevice m_vk_device{VK_NULL_HANDLE};
+  VkPhysicalDeviceProperties m_device_properties = {};
+  std::filesystem::path m_path{};
+  VkPipelineCacheHandle m_cache{};
+};
+
+}  // namespace VkStartup
@@ -0,0 +1,91 @@
+#include "VkStartup/Context/Rendering.h"
+#include "VkStartup/Context/Context.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Exceptions.h"
+#include "VkShared/Macros.h"
+
+namespace VkStartup {
+
+RenderingData RenderingData::swapchain(const VkSwapchainContext& swap_ctx, const uint32_t image_index,
+                                       const VkClearColorValue clear_color) {
+  const auto& rp_buffers = swap_ctx.rp_buffers;
+  const auto& depth_views = swap_ctx.offscreen.depth_views;
+
+  RenderingData data{};
+  auto& color = data.color_attachments.emplace_back();
+  color.view = rp_buffers.image_views.at(image_index)();
+  color.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  color.clear_value.color = clear_color;
+
+  if (image_index < depth_views.size()) {
+    data.depth_attachment.view = depth_views[image_index]();
+    data.depth_attachment.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    data.depth_attachment.store_op = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    data.depth_attachment.clear_value.depthStencil = VkClearDepthStencilValue{1.0f, 0};
+  }
+
+  data.render_area = VkRect2D{VkOffset2D{0, 0}, VkExtent2D{rp_buffers.width, rp_buffers.height}};
+  return data;
+}
+
+RenderingInfo::RenderingInfo(const RenderingData& data) : m_info{CreateInfo::vk_rendering_info()} {
+  m_color_attachments.reserve(data.color_attachments.size());
+  for (const auto& attachment : data.color_attachments) {
+    m_color_attachments.push_back(attachment_info(attachment));
+  }
+  m_info.flags = data.flags;
+  m_info.renderArea = data.render_area;
+  m_info.layerCount = data.layer_count;
+  m_info.viewMask = data.view_mask;
+  m_info.colorAttachmentCount = static_cast<uint32_t>(m_color_attachments.size());
+  m_info.pColorAttachments = m_color_attachments.data();
+
+  if (data.depth_attachment.view) {
+    m_depth_attachment = attachment_info(data.depth_attachment);
+    m_info.pDepthAttachment = &m_depth_attachment;
+    if (data.depth_has_stencil) {
+      m_info.pStencilAttachment = &m_depth_attachment;
+    }
+  }
+
+#ifndef NDEBUG
+  if (data.render_area.extent.width == 0 || data.render_area.extent.height == 0) {
+    VkWarning("Dynamic rendering area has a zero extent");
+  }
+#endif
+}
+
+const VkRenderingInfo& RenderingInfo::info() const {
+  return m_info;
+}
+
+void RenderingInfo::begin(const VkContext& ctx, VkCommandBuffer cmd) const {
+  if (!ctx.cmd_begin_rendering) {
+    VkError("Dynamic rendering is not enabled on this device");
+    throw Exceptions::VkStartupException();
+  }
+  ctx.cmd_begin_rendering(cmd, &m_info);
+}
+
+void RenderingInfo::end(const VkContext& ctx, VkCommandBuffer cmd) {
+  if (!ctx.cmd_end_rendering) {
+    VkError("Dynamic rendering is not enabled on this device");
+    throw Exceptions::VkStartupException();
+  }
+  ctx.cmd_end_rendering(cmd);
+}
+
+VkRenderingAttachmentInfo RenderingInfo::attachment_info(const RenderingAttachment& attachment) {
+  auto info = CreateInfo::vk_rendering_attachment_info();
+  info.imageView = attachment.view;
+  info.imageLayout = attachment.layout;
+  info.loadOp = attachment.load_op;
+  info.storeOp = attachment.store_op;
+  info.clearValue = attachment.clear_value;
+  info.resolveMode = attachment.resolve_mode;
+  info.resolveImageView = attachment.resolve_view;
+  info.resolveImageLayout = attachment.resolve_layout;
+  return info;
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,71 @@
+#pragma once
+#include <vulkan/vulkan_core.h>
+#include <vector>
+
+namespace VkStartup {
+
+struct VkContext;
+struct VkSwapchainContext;
+
+// Dynamic rendering (VK_KHR_dynamic_rendering / Vulkan 1.3) alternative to 'RenderpassData'.
+// No VkRenderPass or VkFramebuffer objects are needed; image views are attached directly
+// when rendering begins.  Layout transitions are not implicit: images must already be in
+// 'layout' (e.g. COLOR_ATTACHMENT_OPTIMAL) and swapchain images must be transitioned to
+// PRESENT_SRC_KHR before 'end_frame'.
+struct RenderingAttachment {
+  VkImageView view{VK_NULL_HANDLE};
+  VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+  VkAttachmentLoadOp load_op{VK_ATTACHMENT_LOAD_OP_CLEAR};
+  VkAttachmentStoreOp store_op{VK_ATTACHMENT_STORE_OP_STORE};
+  VkClearValue clear_value = {};
+
+  // Resolve (optional; multisampled attachments)
+  VkImageView resolve_view{VK_NULL_HANDLE};
+  VkImageLayout resolve_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+  VkResolveModeFlagBits resolve_mode{VK_RESOLVE_MODE_NONE};
+};
+
+struct RenderingData {
+  // Color
+  std::vector<RenderingAttachment> color_attachments{};
+
+  // Depth (unused when 'view' is null).  The same attachment is bound as stencil if requested.
+  RenderingAttachment depth_attachment = {};
+  bool depth_has_stencil{false};
+
+  VkRect2D render_area = {};
+  uint32_t layer_count{1};
+  uint32_t view_mask{0};
+  VkRenderingFlags flags{0};
+
+  // Color (and depth, for offscreen targets) views for a swapchain or offscreen image
+  [[nodiscard]] static RenderingData swapchain(const VkSwapchainContext& swap_ctx, uint32_t image_index,
+                                               VkClearColorValue clear_color = {});
+};
+
+// Owns the attachment arrays that 'VkRenderingInfo' points at.  Not copyable or movable so
+// the pointers stay valid.
+class RenderingInfo {
+ public:
+  explicit RenderingInfo(const RenderingData& data);
+
+  RenderingInfo(const RenderingInfo& source) = delete;
+  RenderingInfo& operator=(const RenderingInfo& rhs) = delete;
+  RenderingInfo(RenderingInfo&& source) noexcept = delete;
+  RenderingInfo& operator=(RenderingInfo&& rhs) noexcept = delete;
+
+  [[nodiscard]] const VkRenderingInfo& info() const;
+
+  // Requires 'PhysicalDeviceInfo::dynamic_rendering'
+  void begin(const VkContext& ctx, VkCommandBuffer cmd) const;
+  static void end(const VkContext& ctx, VkCommandBuffer cmd);
+
+ private:
+  [[nodiscard]] static VkRenderingAttachmentInfo attachment_info(const RenderingAttachment& attachment);
+
+  std::vector<VkRenderingAttachmentInfo> m_color_attachments{};
+  VkRenderingAttachmentInfo m_depth_attachment = {};
+  VkRenderingInfo m_info = {};
+};
+
+}  // namespace VkStartup
@@ -4,39 +4,25 @@
 
 namespace VkStartup {
 
-VkRenderPassHandle RenderpassBuilder::create_renderpass(RenderpassData& data, VkDevice device,
+VkRenderPassHandle RenderpassBuilder::create_renderpass(const RenderpassData& data, VkDevice device,
                                                         const bool implicit_transition) {
   auto info = CreateInfo::vk_renderpass_create_info();
 
   // Combine attachments
-  std::vector<VkAttachmentDescription> attachments{};
-  attachments.insert(attachments.end(), data.color_attachments.begin(), data.color_attachments.end());
-  attachments.insert(attachments.end(), data.resolve_attachments.begin(), data.resolve_attachments.end());
-  attachments.insert(attachments.end(), data.preserve_attachments.begin(), data.preserve_attachments.end());
-
-  if (data.depth_attachment.format != VK_FORMAT_UNDEFINED) {
-    attachments.push_back(data.depth_attachment);
-  }
+  const auto all_attachments = attachments(data);
 
   // Load attachments
-  info.pAttachments = attachments.data();
-  info.attachmentCount = static_cast<uint32_t>(attachments.size());
+  info.pAttachments = all_attachments.data();
+  info.attachmentCount = static_cast<uint32_t>(all_attachments.size());
 
   // Load subpass descriptions
   info.pSubpasses = data.subpass_descs.data();
   info.subpassCount = static_cast<uint32_t>(data.subpass_descs.size());
 
   // Load subpass dependencies
-  if (implicit_transition) {
-    add_implicit_transition_dependency(data);
-  }
-  // Depth subpass dependency
-  if (data.depth_attachment.format != VK_FORMAT_UNDEFINED) {
-    add_depth_transition_dependency(data);
-  }
-
-  info.pDependencies = data.subpass_dependencies.data();
-  info.dependencyCount = static_cast<uint32_t>(data.subpass_dependencies.size());
+  const auto all_dependencies = dependencies(data, implicit_transition);
+  info.pDependencies = all_dependencies.data();
+  info.dependencyCount = static_cast<uint32_t>(all_dependencies.size());
 
 #ifndef NDEBUG
   if (data.color_attachments.empty()) {
@@ -62,7 +48,32 @@ VkRenderPassHandle RenderpassBuilder::create_renderpass(RenderpassData& data, Vk
   return VkRenderPassHandle{info, device};
 }
 
-void RenderpassBuilder::add_implicit_transition_dependency(RenderpassData& rp_data) {
+std::vector<VkAttachmentDescription> RenderpassBuilder::attachments(const RenderpassData& data) {
+  std::vector<VkAttachmentDescription> attachments{};
+  attachments.insert(attachments.end(), data.color_attachments.begin(), data.color_attachments.end());
+  attachments.insert(attachments.end(), data.resolve_attachments.begin(), data.resolve_attachments.end());
+  attachments.insert(attachments.end(), data.preserve_attachments.begin(), data.preserve_attachments.end());
+
+  if (data.depth_attachment.format != VK_FORMAT_UNDEFINED) {
+    attachments.push_back(data.depth_attachment);
+  }
+  return attachments;
+}
+
+std::vector<VkSubpassDependency> RenderpassBuilder::dependencies(const RenderpassData& data,
+                                                                 const bool implicit_transition) {
+  std::vector<VkSubpassDependency> dependencies{data.subpass_dependencies};
+  if (implicit_transition) {
+    add_implicit_transition_dependency(dependencies);
+  }
+  // Depth subpass dependency
+  if (data.depth_attachment.format != VK_FORMAT_UNDEFINED) {
+    add_depth_transition_dependency(dependencies);
+  }
+  return dependencies;
+}
+
+void RenderpassBuilder::add_implicit_transition_dependency(std::vector<VkSubpassDependency>& dependencies) {
   // This is not needed if the renderpass being created waits to run
   // by using the stage: VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT.  This ensures
   // the image is available.  If a different stage is used, this implicit
@@ -83,10 +94,10 @@ void RenderpassBuilder::add_implicit_transition_dependency(RenderpassData& rp_da
   dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
   dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
-  rp_data.subpass_dependencies.push_back(dependency);
+  dependencies.push_back(dependency);
 }
 
-void RenderpassBuilder::add_depth_transition_dependency(RenderpassData& rp_data) {
+void RenderpassBuilder::add_depth_transition_dependency(std::vector<VkSubpassDependency>& dependencies) {
   VkSubpassDependency dependency = {};
   dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
   dependency.dstSubpass = 0;
@@ -94,7 +105,7 @@ void RenderpassBuilder::add_depth_transition_dependency(RenderpassData& rp_data)
   dependency.srcAccessMask = 0;
   dependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
   dependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-  rp_data.subpass_dependencies.push_back(dependency);
+  dependencies.push_back(dependency);
 }
 
 }  // namespace VkStartup
@@ -11,7 +11,8 @@ struct RenderpassBuffers {
   VkRenderPassHandle renderpass{};
   std::vector<VkImage> vk_images{VK_NULL_HANDLE};
   std::vector<VkImageViewHandle> image_views{};
-  std::vector<VkFramebufferHandle> framebuffers{};
+  // Owned by 'VkContext::framebuffer_cache' (see 'FramebufferCache::swapchain_framebuffers')
+  std::vector<VkFramebuffer> framebuffers{};
 };
 
 struct RenderpassData {
@@ -38,12 +39,19 @@ struct RenderpassData {
 
 class RenderpassBuilder {
  public:
-  [[nodiscard]] static VkRenderPassHandle create_renderpass(RenderpassData& data, VkDevice device,
+  // 'data' is not modified; implicit & depth dependencies are added to a local copy
+  [[nodiscard]] static VkRenderPassHandle create_renderpass(const RenderpassData& data, VkDevice device,
                                                             const bool implicit_transition = true);
 
+  // Attachments in the order referenced by the renderpass: color, resolve, preserve, depth
+  [[nodiscard]] static std::vector<VkAttachmentDescription> attachments(const RenderpassData& data);
+  // User dependencies followed by the implicit & depth transition dependencies
+  [[nodiscard]] static std::vector<VkSubpassDependency> dependencies(const RenderpassData& data,
+                                                                     const bool implicit_transition);
+
  private:
-  static void add_implicit_transition_dependency(RenderpassData& rp_data);
-  static void add_depth_transition_dependency(RenderpassData& rp_data);
+  static void add_implicit_transition_dependency(std::vector<VkSubpassDependency>& dependencies);
+  static void add_depth_transition_dependency(std::vector<VkSubpassDependency>& dependencies);
 };
 
 }  // namespace VkStartup
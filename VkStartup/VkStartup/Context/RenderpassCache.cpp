@@ -0,0 +1,107 @@
+#include "VkStartup/Context/RenderpassCache.h"
+#include "VkStartup/Context/FramebufferCache.h"
+#include <ranges>
+
+namespace VkStartup {
+
+namespace {
+
+void append(std::vector<uint32_t>& key, const VkAttachmentDescription& desc) {
+  key.insert(key.end(), {desc.flags, static_cast<uint32_t>(desc.format), static_cast<uint32_t>(desc.samples),
+                         static_cast<uint32_t>(desc.loadOp), static_cast<uint32_t>(desc.storeOp),
+                         static_cast<uint32_t>(desc.stencilLoadOp), static_cast<uint32_t>(desc.stencilStoreOp),
+                         static_cast<uint32_t>(desc.initialLayout), static_cast<uint32_t>(desc.finalLayout)});
+}
+
+void append(std::vector<uint32_t>& key, const VkAttachmentReference* refs, const uint32_t count) {
+  key.push_back(refs ? count : 0);
+  for (uint32_t i = 0; refs && i < count; i++) {
+    key.insert(key.end(), {refs[i].attachment, static_cast<uint32_t>(refs[i].layout)});
+  }
+}
+
+void append(std::vector<uint32_t>& key, const VkSubpassDescription& desc) {
+  key.insert(key.end(), {desc.flags, static_cast<uint32_t>(desc.pipelineBindPoint)});
+  append(key, desc.pInputAttachments, desc.inputAttachmentCount);
+  append(key, desc.pColorAttachments, desc.colorAttachmentCount);
+  // Resolve attachments (if any) match the color attachment count
+  append(key, desc.pResolveAttachments, desc.pResolveAttachments ? desc.colorAttachmentCount : 0);
+  append(key, desc.pDepthStencilAttachment, 1);
+  key.push_back(desc.pPreserveAttachments ? desc.preserveAttachmentCount : 0);
+  for (uint32_t i = 0; desc.pPreserveAttachments && i < desc.preserveAttachmentCount; i++) {
+    key.push_back(desc.pPreserveAttachments[i]);
+  }
+}
+
+void append(std::vector<uint32_t>& key, const VkSubpassDependency& dep) {
+  key.insert(key.end(), {dep.srcSubpass, dep.dstSubpass, dep.srcStageMask, dep.dstStageMask, dep.srcAccessMask,
+                         dep.dstAccessMask, dep.dependencyFlags});
+}
+
+}  // namespace
+
+RenderpassCache::RenderpassCache(VkDevice device, FramebufferCache* framebuffers)
+    : m_vk_device{device}, m_framebuffers{framebuffers} {
+}
+
+VkRenderPass RenderpassCache::get(const RenderpassData& data, const bool implicit_transition) {
+  auto key = make_key(data, implicit_transition);
+
+  std::lock_guard lock{m_mutex};
+  if (const auto itr = m_renderpasses.find(key); itr != m_renderpasses.end()) {
+    return itr->second();
+  }
+  const auto [itr, inserted] = m_renderpasses.emplace(
+      std::move(key), RenderpassBuilder::create_renderpass(data, m_vk_device, implicit_transition));
+  return itr->second();
+}
+
+size_t RenderpassCache::size() const {
+  std::lock_guard lock{m_mutex};
+  return m_renderpasses.size();
+}
+
+void RenderpassCache::clear() {
+  std::lock_guard lock{m_mutex};
+  // Framebuffers are keyed by renderpass handle; a recycled handle could match a stale entry
+  if (m_framebuffers) {
+    for (const auto& renderpass : m_renderpasses | std::views::values) {
+      static_cast<void>(m_framebuffers->invalidate(renderpass()));
+    }
+  }
+  m_renderpasses.clear();
+}
+
+RenderpassCache::Key RenderpassCache::make_key(const RenderpassData& data, const bool implicit_transition) {
+  // Counts prefix each section so different layouts can't serialize to the same key
+  Key key{};
+  const auto attachments = RenderpassBuilder::attachments(data);
+  key.push_back(static_cast<uint32_t>(attachments.size()));
+  for (const auto& attachment : attachments) {
+    append(key, attachment);
+  }
+
+  key.push_back(static_cast<uint32_t>(data.subpass_descs.size()));
+  for (const auto& subpass : data.subpass_descs) {
+    append(key, subpass);
+  }
+
+  const auto dependencies = RenderpassBuilder::dependencies(data, implicit_transition);
+  key.push_back(static_cast<uint32_t>(dependencies.size()));
+  for (const auto& dependency : dependencies) {
+    append(key, dependency);
+  }
+  return key;
+}
+
+size_t RenderpassCache::KeyHash::operator()(const Key& key) const noexcept {
+  // FNV-1a
+  uint64_t hash{14695981039346656037ull};
+  for (const auto value : key) {
+    hash ^= value;
+    hash *= 1099511628211ull;
+  }
+  return static_cast<size_t>(hash);
+}
+
+}  // namespace VkStartup
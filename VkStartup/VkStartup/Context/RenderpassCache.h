@@ -0,0 +1,52 @@
+#pragma once
+#include "VkStartup/Context/Renderpass.h"
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace VkStartup {
+
+class FramebufferCache;
+
+// Hash-consed renderpasses.  Identical descriptions (attachments, subpasses and the final
+// dependency list, including the implicit & depth transitions) share one VkRenderPass.
+// Subpass attachment references are compared by value, not by pointer.  Renderpasses are
+// owned by the cache and live until it is destroyed or cleared.
+class RenderpassCache {
+ public:
+  // Framebuffers built from the cached renderpasses are invalidated in 'framebuffers' when the
+  // cache is cleared (it must outlive this cache)
+  explicit RenderpassCache(VkDevice device, FramebufferCache* framebuffers = nullptr);
+
+  RenderpassCache(const RenderpassCache& source) = delete;
+  RenderpassCache& operator=(const RenderpassCache& rhs) = delete;
+  RenderpassCache(RenderpassCache&& source) noexcept = delete;
+  RenderpassCache& operator=(RenderpassCache&& rhs) noexcept = delete;
+
+  // Thread safe.  Creates the renderpass on first use.
+  [[nodiscard]] VkRenderPass get(const RenderpassData& data, bool implicit_transition = true);
+
+  [[nodiscard]] size_t size() const;
+
+  // Destroys every cached renderpass and the framebuffers built from them.  None of them may
+  // still be in use.
+  void clear();
+
+ private:
+  using Key = std::vector<uint32_t>;
+  struct KeyHash {
+    size_t operator()(const Key& key) const noexcept;
+  };
+
+  [[nodiscard]] static Key make_key(const RenderpassData& data, bool implicit_transition);
+
+  VkDevice m_vk_device{VK_NULL_HANDLE};
+  FramebufferCache* m_framebuffers{nullptr};
+  mutable std::mutex m_mutex{};
+  std::unordered_map<Key, VkRenderPassHandle, KeyHash> m_renderpasses{};
+};
+
+}  // namespace VkStartup
@@ -132,4 +132,181 @@ class CreateDestroyRenderPass {
   VkDevice m_device{VK_NULL_HANDLE};
 };
 
+class CreateDestroyPipelineCache {
+ public:
+  void create() {
+    handle = VK_NULL_HANDLE;
+  }
+  void create(const VkPipelineCacheCreateInfo& info, VkDevice vk_device) {
+    VkCheck(vkCreatePipelineCache(vk_device, &info, nullptr, &handle), Exceptions::VkStartupException());
+    m_device = vk_device;
+  }
+  void destroy() const {
+    if (handle && m_device) {
+      vkDestroyPipelineCache(m_device, handle, nullptr);
+    }
+  }
+  VkPipelineCache handle{VK_NULL_HANDLE};
+
+ private:
+  VkDevice m_device{VK_NULL_HANDLE};
+};
+
+class CreateDestroySemaphore {
+ public:
+  void create() {
+    handle = VK_NULL_HANDLE;
+  }
+  void create(const VkSemaphoreCreateInfo& info, VkDevice vk_device) {
+    VkCheck(vkCreateSemaphore(vk_device, &info, nullptr, &handle), Exceptions::VkStartupException());
+    m_device = vk_device;
+  }
+  void destroy() const {
+    if (handle && m_device) {
+      vkDestroySemaphore(m_device, handle, nullptr);
+    }
+  }
+  VkSemaphore handle{VK_NULL_HANDLE};
+
+ private:
+  VkDevice m_device{VK_NULL_HANDLE};
+};
+
+class CreateDestroyTimelineSemaphore {
+ public:
+  void create() {
+    handle = VK_NULL_HANDLE;
+  }
+  void create(const uint64_t initial_value, VkDevice vk_device) {
+    VkSemaphoreTypeCreateInfo type_info = {};
+    type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_info.initialValue = initial_value;
+
+    VkSemaphoreCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    info.pNext = &type_info;
+    VkCheck(vkCreateSemaphore(vk_device, &info, nullptr, &handle), Exceptions::VkStartupException());
+    m_device = vk_device;
+  }
+  void destroy() const {
+    if (handle && m_device) {
+      vkDestroySemaphore(m_device, handle, nullptr);
+    }
+  }
+  VkSemaphore handle{VK_NULL_HANDLE};
+
+ private:
+  VkDevice m_device{VK_NULL_HANDLE};
+};
+
+class CreateDestroyFence {
+ public:
+  void create() {
+    handle = VK_NULL_HANDLE;
+  }
+  void create(const VkFenceCreateInfo& info, VkDevice vk_device) {
+    VkCheck(vkCreateFence(vk_device, &info, nullptr, &handle), Exceptions::VkStartupException());
+    m_device = vk_device;
+  }
+  void destroy() const {
+    if (handle && m_device) {
+      vkDestroyFence(m_device, handle, nullptr);
+    }
+  }
+  VkFence handle{VK_NULL_HANDLE};
+
+ private:
+  VkDevice m_device{VK_NULL_HANDLE};
+};
+
+class CreateDestroyCommandPool {
+ public:
+  void create() {
+    handle = VK_NULL_HANDLE;
+  }
+  void create(const VkCommandPoolCreateInfo& info, VkDevice vk_device) {
+    VkCheck(vkCreateCommandPool(vk_device, &info, nullptr, &handle), Exceptions::VkStartupException());
+    m_device = vk_device;
+  }
+  void destroy() const {
+    if (handle && m_device) {
+      vkDestroyCommandPool(m_device, handle, nullptr);
+    }
+  }
+  VkCommandPool handle{VK_NULL_HANDLE};
+
+ private:
+  VkDevice m_device{VK_NULL_HANDLE};
+};
+
+class CreateDestroyVmaImage {
+ public:
+  void create() {
+    handle = VK_NULL_HANDLE;
+  }
+  void create(const VkImageCreateInfo& info, const VmaAllocationCreateInfo& alloc_info, VmaAllocator allocator) {
+    VkCheck(vmaCreateImage(allocator, &info, &alloc_info, &handle, &m_allocation, nullptr),
+            Exceptions::VkStartupException());
+    m_allocator = allocator;
+  }
+  void destroy() const {
+    if (handle && m_allocator) {
+      vmaDestroyImage(m_allocator, handle, m_allocation);
+    }
+  }
+  VkImage handle{VK_NULL_HANDLE};
+
+ private:
+  VmaAllocator m_allocator{VK_NULL_HANDLE};
+  VmaAllocation m_allocation{VK_NULL_HANDLE};
+};
+
+class CreateDestroyVmaBuffer {
+ public:
+  void create() {
+    handle = VK_NULL_HANDLE;
+  }
+  // 'allocation' and 'allocation_info' optionally receive the allocation (e.g. for mapped pointers)
+  void create(const VkBufferCreateInfo& info, const VmaAllocationCreateInfo& alloc_info, VmaAllocator allocator,
+              VmaAllocation* allocation = nullptr, VmaAllocationInfo* allocation_info = nullptr) {
+    VkCheck(vmaCreateBuffer(allocator, &info, &alloc_info, &handle, &m_allocation, allocation_info),
+            Exceptions::VkStartupException());
+    m_allocator = allocator;
+    if (allocation) {
+      *allocation = m_allocation;
+    }
+  }
+  void destroy() const {
+    if (handle && m_allocator) {
+      vmaDestroyBuffer(m_allocator, handle, m_allocation);
+    }
+  }
+  VkBuffer handle{VK_NULL_HANDLE};
+
+ private:
+  VmaAllocator m_allocator{VK_NULL_HANDLE};
+  VmaAllocation m_allocation{VK_NULL_HANDLE};
+};
+
+class CreateDestroyVmaPool {
+ public:
+  void create() {
+    handle = VK_NULL_HANDLE;
+  }
+  void create(const VmaPoolCreateInfo& info, VmaAllocator allocator) {
+    VkCheck(vmaCreatePool(allocator, &info, &handle), Exceptions::VkStartupException());
+    m_allocator = allocator;
+  }
+  void destroy() const {
+    if (handle && m_allocator) {
+      vmaDestroyPool(m_allocator, handle);
+    }
+  }
+  VmaPool handle{VK_NULL_HANDLE};
+
+ private:
+  VmaAllocator m_allocator{VK_NULL_HANDLE};
+};
+
 }  // namespace VkStartup
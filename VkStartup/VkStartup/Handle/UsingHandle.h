@@ -10,4 +10,12 @@ using VkImageViewHandle = VkShared::THandle<CreateDestroyImageView>;
 using VmaAllocatorHandle = VkShared::THandle<CreateDestroyVMA>;
 using VkFramebufferHandle = VkShared::THandle<CreateDestroyFramebuffer>;
 using VkRenderPassHandle = VkShared::THandle<CreateDestroyRenderPass>;
+using VkPipelineCacheHandle = VkShared::THandle<CreateDestroyPipelineCache>;
+using VkSemaphoreHandle = VkShared::THandle<CreateDestroySemaphore>;
+using VkTimelineSemaphoreHandle = VkShared::THandle<CreateDestroyTimelineSemaphore>;
+using VkFenceHandle = VkShared::THandle<CreateDestroyFence>;
+using VkCommandPoolHandle = VkShared::THandle<CreateDestroyCommandPool>;
+using VmaImageHandle = VkShared::THandle<CreateDestroyVmaImage>;
+using VmaBufferHandle = VkShared::THandle<CreateDestroyVmaBuffer>;
+using VmaPoolHandle = VkShared::THandle<CreateDestroyVmaPool>;
 }  // namespace VkStartup
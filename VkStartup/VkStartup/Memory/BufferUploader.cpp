@@ -0,0 +1,94 @@
+#include "VkStartup/Memory/BufferUploader.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Exceptions.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace VkStartup {
+
+BufferUploader::BufferUploader(const VkContext& ctx, const VkDeviceSize staging_size)
+    : m_allocator{ctx.mem_alloc()},
+      m_direct_upload{ctx.phy_device_info.memory_topology.direct_upload()},
+      m_batcher{ctx, staging_size} {
+}
+
+UploadBuffer BufferUploader::create_buffer(const VkDeviceSize size, const VkBufferUsageFlags usage) const {
+  const auto buffer_info = CreateInfo::vk_buffer_create_info(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+  // VMA may still pick memory that isn't host visible (e.g. the heap is full); such
+  // buffers are staged like on devices without resizable BAR.
+  auto alloc_info = CreateInfo::vma_allocation_create_info(VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0);
+  if (m_direct_upload) {
+    constexpr VmaAllocationCreateFlags flags{VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                                             VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                                             VMA_ALLOCATION_CREATE_MAPPED_BIT};
+    alloc_info = CreateInfo::vma_allocation_create_info(VMA_MEMORY_USAGE_AUTO, flags);
+  }
+
+  UploadBuffer upload{};
+  VmaAllocationInfo allocation_info = {};
+  upload.buffer = VmaBufferHandle{buffer_info, alloc_info, m_allocator, &upload.allocation, &allocation_info};
+  upload.size = size;
+
+  VkMemoryPropertyFlags memory_flags{0};
+  vmaGetAllocationMemoryProperties(m_allocator, upload.allocation, &memory_flags);
+  if (memory_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+    upload.mapped = static_cast<std::byte*>(allocation_info.pMappedData);
+  }
+  return upload;
+}
+
+UploadToken BufferUploader::write(const UploadBuffer& buffer, const std::span<const std::byte> data,
+                                  const VkDeviceSize offset) {
+  if (offset + data.size() > buffer.size) {
+    VkError("Upload of " + std::to_string(data.size()) + " bytes at offset " + std::to_string(offset) +
+            " exceeds the buffer size of " + std::to_string(buffer.size) + " bytes");
+    throw Exceptions::VkStartupException();
+  }
+  if (data.empty()) {
+    return 0;
+  }
+
+  if (buffer.direct()) {
+    // No-op flush for host coherent memory
+    std::memcpy(buffer.mapped + offset, data.data(), data.size());
+    VkCheck(vmaFlushAllocation(m_allocator, buffer.allocation, offset, data.size()),
+            Exceptions::VkStartupException());
+    m_direct_bytes += data.size();
+    return 0;
+  }
+
+  // Writes larger than the staging ring are split
+  const VkDeviceSize chunk_size = m_batcher.staging().capacity();
+  UploadToken token{0};
+  for (VkDeviceSize done = 0; done < data.size(); done += chunk_size) {
+    const auto chunk = std::min<VkDeviceSize>(chunk_size, data.size() - done);
+    token = m_batcher.upload_buffer(buffer.buffer(), data.subspan(done, chunk), offset + done);
+  }
+  m_staged_bytes += data.size();
+  return token;
+}
+
+void BufferUploader::flush() {
+  m_batcher.wait(m_batcher.flush());
+}
+
+UploadBatcher& BufferUploader::batcher() {
+  return m_batcher;
+}
+
+bool BufferUploader::direct_upload() const {
+  return m_direct_upload;
+}
+
+uint64_t BufferUploader::direct_bytes() const {
+  return m_direct_bytes;
+}
+
+uint64_t BufferUploader::staged_bytes() const {
+  return m_staged_bytes;
+}
+
+}  // namespace VkStartup
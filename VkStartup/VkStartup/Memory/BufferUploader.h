@@ -0,0 +1,70 @@
+#pragma once
+#include "VkStartup/Context/Context.h"
+#include "VkStartup/Handle/UsingHandle.h"
+#include "VkStartup/Memory/UploadBatcher.h"
+#include <vulkan/vulkan_core.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace VkStartup {
+
+// Device local buffer created by 'BufferUploader'.  'mapped' is set when the allocation is
+// host visible and is written in place.
+struct UploadBuffer {
+  VmaBufferHandle buffer{};
+  VmaAllocation allocation{VK_NULL_HANDLE};
+  std::byte* mapped{nullptr};
+  VkDeviceSize size{0};
+
+  [[nodiscard]] bool direct() const {
+    return mapped != nullptr;
+  }
+};
+
+// Uploads to device local buffers.  When the device exposes host visible device local memory
+// ('MemoryTopology::direct_upload', i.e. resizable BAR or unified memory) buffers are mapped
+// and written directly, so the data crosses the bus once.  Otherwise the data is staged through
+// an 'UploadBatcher' and copied on the transfer queue.
+//
+// The destination must not be in use by the GPU while it is written (e.g. one buffer per
+// frame in flight).  Staged writes must complete (see 'flush' & 'batcher') before the GPU
+// reads them.
+class BufferUploader {
+ public:
+  explicit BufferUploader(const VkContext& ctx, VkDeviceSize staging_size = 16ull << 20);
+
+  BufferUploader(const BufferUploader& source) = delete;
+  BufferUploader& operator=(const BufferUploader& rhs) = delete;
+  BufferUploader(BufferUploader&& source) noexcept = delete;
+  BufferUploader& operator=(BufferUploader&& rhs) noexcept = delete;
+
+  // 'usage' is extended with VK_BUFFER_USAGE_TRANSFER_DST_BIT for the staging fallback
+  [[nodiscard]] UploadBuffer create_buffer(VkDeviceSize size, VkBufferUsageFlags usage) const;
+
+  // Direct writes are complete on return (token 0).  Staged writes are batched until the
+  // next flush.
+  UploadToken write(const UploadBuffer& buffer, std::span<const std::byte> data, VkDeviceSize offset = 0);
+
+  // Submits the staged writes & blocks until they completed
+  void flush();
+
+  // Asynchronous flushes & polling of staged writes
+  [[nodiscard]] UploadBatcher& batcher();
+
+  // Device local memory is host visible (see 'MemoryTopology')
+  [[nodiscard]] bool direct_upload() const;
+  // Bytes written in place / through the staging ring
+  [[nodiscard]] uint64_t direct_bytes() const;
+  [[nodiscard]] uint64_t staged_bytes() const;
+
+ private:
+  VmaAllocator m_allocator{VK_NULL_HANDLE};
+  bool m_direct_upload{false};
+  UploadBatcher m_batcher;
+
+  uint64_t m_direct_bytes{0};
+  uint64_t m_staged_bytes{0};
+};
+
+}  // namespace VkStartup
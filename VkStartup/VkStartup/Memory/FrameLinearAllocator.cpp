@@ -0,0 +1,110 @@
+#include "VkStartup/Memory/FrameLinearAllocator.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Exceptions.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+#include <string>
+
+namespace VkStartup {
+
+namespace {
+
+// Largest offset alignment required by any descriptor type the buffer can be bound as
+VkDeviceSize offset_alignment(const VkPhysicalDeviceLimits& limits, const VkBufferUsageFlags usage) {
+  VkDeviceSize alignment{1};
+  if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+    alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+  }
+  if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
+    alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+  }
+  if (usage & (VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT)) {
+    alignment = std::max(alignment, limits.minTexelBufferOffsetAlignment);
+  }
+  return alignment;
+}
+
+}  // namespace
+
+FrameLinearAllocator::FrameLinearAllocator(const VkContext& ctx, const VkDeviceSize frame_size,
+                                           const uint32_t frame_count, const VkBufferUsageFlags usage)
+    : m_allocator{ctx.mem_alloc()}, m_frame_size{std::max<VkDeviceSize>(frame_size, 1)} {
+  VkPhysicalDeviceProperties properties = {};
+  vkGetPhysicalDeviceProperties(ctx.phy_device_info.vk_phy_device, &properties);
+  m_alignment = offset_alignment(properties.limits, usage);
+
+  // Written once by the CPU & read by the GPU: VMA prefers host visible device local memory
+  const auto buffer_info = CreateInfo::vk_buffer_create_info(m_frame_size, usage);
+  auto alloc_info = CreateInfo::vma_allocation_create_info(
+      VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+  uint32_t memory_type_index{0};
+  VkCheck(vmaFindMemoryTypeIndexForBufferInfo(m_allocator, &buffer_info, &alloc_info, &memory_type_index),
+          Exceptions::VkStartupException());
+
+  // Sized for every frame; padding between the buffers spills into a second block
+  const uint32_t count = std::max(frame_count, 1u);
+  m_pool = VmaPoolHandle{
+      CreateInfo::vma_pool_create_info(memory_type_index, VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT, m_frame_size * count),
+      m_allocator};
+
+  alloc_info.pool = m_pool();
+  m_frames.resize(count);
+  for (auto& frame : m_frames) {
+    VmaAllocationInfo allocation_info = {};
+    frame.buffer = VmaBufferHandle{buffer_info, alloc_info, m_allocator, &frame.allocation, &allocation_info};
+    frame.mapped = static_cast<std::byte*>(allocation_info.pMappedData);
+  }
+}
+
+void FrameLinearAllocator::reset(const uint32_t frame_index) {
+  m_current = frame_index % static_cast<uint32_t>(m_frames.size());
+  auto& frame = m_frames[m_current];
+  frame.offset = 0;
+  frame.flushed = 0;
+}
+
+LinearAllocation FrameLinearAllocator::allocate(const VkDeviceSize size, const VkDeviceSize alignment) {
+  auto& frame = m_frames[m_current];
+  const VkDeviceSize align = alignment > 0 ? alignment : m_alignment;
+  const VkDeviceSize offset = (frame.offset + align - 1) / align * align;
+  if (offset + size > m_frame_size) {
+    VkError("Frame linear allocation of " + std::to_string(size) + " bytes exceeds the frame size of " +
+            std::to_string(m_frame_size) + " bytes (" + std::to_string(frame.offset) + " used)");
+    throw Exceptions::VkStartupException();
+  }
+
+  frame.offset = offset + size;
+  m_high_water_mark = std::max(m_high_water_mark, frame.offset);
+  return LinearAllocation{frame.buffer(), offset, size, frame.mapped + offset};
+}
+
+void FrameLinearAllocator::flush() {
+  auto& frame = m_frames[m_current];
+  if (frame.offset > frame.flushed) {
+    VkCheck(vmaFlushAllocation(m_allocator, frame.allocation, frame.flushed, frame.offset - frame.flushed),
+            Exceptions::VkStartupException());
+    frame.flushed = frame.offset;
+  }
+}
+
+VkDeviceSize FrameLinearAllocator::alignment() const {
+  return m_alignment;
+}
+
+VkDeviceSize FrameLinearAllocator::frame_size() const {
+  return m_frame_size;
+}
+
+uint32_t FrameLinearAllocator::frame_index() const {
+  return m_current;
+}
+
+VkDeviceSize FrameLinearAllocator::used() const {
+  return m_frames[m_current].offset;
+}
+
+VkDeviceSize FrameLinearAllocator::high_water_mark() const {
+  return m_high_water_mark;
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,109 @@
+#pragma once
+#include "VkStartup/Context/Context.h"
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace VkStartup {
+
+// Suballocation of a 'FrameLinearAllocator'.  Valid until its frame is reset.
+struct LinearAllocation {
+  VkBuffer buffer{VK_NULL_HANDLE};
+  VkDeviceSize offset{0};
+  VkDeviceSize size{0};
+  // Mapped memory at 'offset'
+  std::byte* mapped{nullptr};
+
+  [[nodiscard]] VkDescriptorBufferInfo descriptor_info() const {
+    return VkDescriptorBufferInfo{buffer, offset, size};
+  }
+};
+
+// Bump pointer allocator for transient per frame data (dynamic uniforms, vertices, indices).
+// Every frame in flight owns a persistently mapped buffer allocated from a VMA pool using the
+// linear algorithm.  Allocating aligns & bumps an offset; a frame's allocations are released
+// together by 'reset' once the GPU finished the frame.
+//
+// Usage per frame:
+//   const auto frame = ctx.begin_frame(id);  // Waits for the frame's fence
+//   linear.reset(frame->frame_index);
+//   const auto ubo = linear.push(uniforms);  // Offset is a valid dynamic uniform/storage offset
+//   ...
+//   linear.flush();                          // Before submitting
+//   ctx.end_frame(id, {cmd});
+//
+// Not thread safe; use one allocator per recording thread.
+class FrameLinearAllocator {
+ public:
+  static constexpr VkBufferUsageFlags default_usage{
+      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+      VK_BUFFER_USAGE_INDEX_BUFFER_BIT};
+
+  explicit FrameLinearAllocator(const VkContext& ctx, VkDeviceSize frame_size, uint32_t frame_count,
+                                VkBufferUsageFlags usage = default_usage);
+
+  FrameLinearAllocator(const FrameLinearAllocator& source) = delete;
+  FrameLinearAllocator& operator=(const FrameLinearAllocator& rhs) = delete;
+  FrameLinearAllocator(FrameLinearAllocator&& source) noexcept = delete;
+  FrameLinearAllocator& operator=(FrameLinearAllocator&& rhs) noexcept = delete;
+
+  // Allocates from 'frame_index' (modulo the frame count), discarding its previous
+  // allocations.  The GPU must be done with them, e.g. after 'begin_frame' waited on the
+  // frame's fence.
+  void reset(uint32_t frame_index);
+
+  // 'alignment' 0 uses 'alignment()'.  Throws when the frame is out of space.
+  [[nodiscard]] LinearAllocation allocate(VkDeviceSize size, VkDeviceSize alignment = 0);
+
+  // Allocates & copies
+  template <typename T>
+  LinearAllocation push(const T& value, const VkDeviceSize alignment = 0) {
+    return push_array(std::span<const T>{&value, 1}, alignment);
+  }
+  template <typename T>
+  LinearAllocation push_array(std::span<const T> values, const VkDeviceSize alignment = 0) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto allocation = allocate(values.size_bytes(), alignment);
+    if (!values.empty()) {
+      std::memcpy(allocation.mapped, values.data(), values.size_bytes());
+    }
+    return allocation;
+  }
+
+  // Makes the current frame's writes since the last flush visible to the device.  No-op for
+  // host coherent memory.
+  void flush();
+
+  // Largest min*OffsetAlignment limit of the usage flags (uniform, storage, texel buffers)
+  [[nodiscard]] VkDeviceSize alignment() const;
+  [[nodiscard]] VkDeviceSize frame_size() const;
+  [[nodiscard]] uint32_t frame_index() const;
+  // Bytes used by the current frame, including alignment padding
+  [[nodiscard]] VkDeviceSize used() const;
+  // Largest 'used' of any frame so far (to tune 'frame_size')
+  [[nodiscard]] VkDeviceSize high_water_mark() const;
+
+ private:
+  struct Frame {
+    VmaBufferHandle buffer{};
+    VmaAllocation allocation{VK_NULL_HANDLE};
+    std::byte* mapped{nullptr};
+    VkDeviceSize offset{0};
+    VkDeviceSize flushed{0};
+  };
+
+  VmaAllocator m_allocator{VK_NULL_HANDLE};
+  VkDeviceSize m_frame_size{0};
+  VkDeviceSize m_alignment{1};
+
+  VmaPoolHandle m_pool{};
+  std::vector<Frame> m_frames{};
+  uint32_t m_current{0};
+  VkDeviceSize m_high_water_mark{0};
+};
+
+}  // namespace VkStartup
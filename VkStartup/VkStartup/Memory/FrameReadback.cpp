@@ -0,0 +1,222 @@
+#include "VkStartup/Memory/FrameReadback.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Exceptions.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+
+namespace VkStartup {
+
+FrameReadback::FrameReadback(const VkContext& ctx, const VkDeviceSize slot_size, const uint32_t slot_count)
+    : m_vk_device{ctx.device()},
+      m_allocator{ctx.mem_alloc()},
+      m_queue{ctx.queue(VkShared::Enums::QueueFamily::Transfer)},
+      m_slot_size{slot_size} {
+  if (!ctx.timelines.empty()) {
+    m_timeline = &ctx.timeline(VkShared::Enums::QueueFamily::Transfer);
+  }
+  init(std::max(slot_count, 1u));
+}
+
+FrameReadback::~FrameReadback() {
+  // A signaled render semaphore must not be destroyed while its signal is pending
+  if (!m_slots.empty() && m_slots[m_next].render_signaled) {
+    consume_render_signal(m_slots[m_next]);
+  }
+  flush();
+}
+
+void FrameReadback::init(const uint32_t slot_count) {
+  m_cmd_pool = VkCommandPoolHandle{
+      CreateInfo::vk_command_pool_create_info(m_queue.family_index, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT),
+      m_vk_device};
+
+  std::vector<VkCommandBuffer> cmds(slot_count);
+  const auto cmd_info = CreateInfo::vk_command_buffer_allocate_info(m_cmd_pool(), VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                                                                    slot_count);
+  VkCheck(vkAllocateCommandBuffers(m_vk_device, &cmd_info, cmds.data()), Exceptions::VkStartupException());
+
+  // Host cached memory is preferred since the CPU reads every byte
+  const auto buffer_info = CreateInfo::vk_buffer_create_info(m_slot_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+  const auto alloc_info = CreateInfo::vma_allocation_create_info(
+      VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+  m_slots.resize(slot_count);
+  for (uint32_t i = 0; i < slot_count; i++) {
+    auto& slot = m_slots[i];
+    VmaAllocationInfo allocation_info = {};
+    slot.buffer = VmaBufferHandle{buffer_info, alloc_info, m_allocator, &slot.allocation, &allocation_info};
+    slot.mapped = static_cast<const std::byte*>(allocation_info.pMappedData);
+    if (!m_timeline) {
+      slot.fence = VkFenceHandle{CreateInfo::vk_fence_create_info(0), m_vk_device};
+    }
+    slot.render_semaphore = VkSemaphoreHandle{CreateInfo::vk_semaphore_create_info(), m_vk_device};
+    slot.cmd = cmds[i];
+  }
+}
+
+VkSemaphore FrameReadback::render_semaphore() {
+  // 'enqueue' was skipped after the signal was submitted: it can't be signaled again
+  if (m_slots[m_next].render_signaled) {
+    consume_render_signal(m_slots[m_next]);
+  }
+
+  // Otherwise an unsignaled semaphore is handed out as is
+  auto& slot = m_slots[m_next];
+  if (slot.pending) {
+    wait_slot(slot);
+    deliver(slot);
+  }
+  return slot.render_semaphore();
+}
+
+void FrameReadback::mark_signaled() {
+  auto& slot = m_slots[m_next];
+  if (slot.render_signaled) {
+    VkError("FrameReadback render semaphore was signaled twice without a wait");
+    throw Exceptions::VkStartupException();
+  }
+  slot.render_signaled = true;
+}
+
+void FrameReadback::enqueue(VkImage image, const VkImageLayout layout, const VkExtent2D extent, Callback callback,
+                            const VkDeviceSize texel_size) {
+  auto& slot = m_slots[m_next];
+  if (!slot.render_signaled) {
+    VkError("FrameReadback::enqueue requires 'render_semaphore' to be signaled (see 'mark_signaled')");
+    throw Exceptions::VkStartupException();
+  }
+
+  const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * texel_size;
+  if (size > m_slot_size) {
+    VkError("Readback of " + std::to_string(size) + " bytes exceeds the slot size of " +
+            std::to_string(m_slot_size) + " bytes");
+    throw Exceptions::VkStartupException();
+  }
+
+  // Record copy
+  const auto begin_info = CreateInfo::vk_command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+  VkCheck(vkBeginCommandBuffer(slot.cmd, &begin_info), Exceptions::VkStartupException());
+
+  VkBufferImageCopy region = {};
+  region.bufferOffset = 0;
+  region.bufferRowLength = 0;
+  region.bufferImageHeight = 0;
+  region.imageSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.imageOffset = VkOffset3D{0, 0, 0};
+  region.imageExtent = VkExtent3D{extent.width, extent.height, 1};
+  vkCmdCopyImageToBuffer(slot.cmd, image, layout, slot.buffer(), 1, &region);
+
+  // Make the transfer writes visible to the host once the submission completes
+  VkBufferMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.buffer = slot.buffer();
+  barrier.offset = 0;
+  barrier.size = size;
+  vkCmdPipelineBarrier(slot.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1,
+                       &barrier, 0, nullptr);
+  VkCheck(vkEndCommandBuffer(slot.cmd), Exceptions::VkStartupException());
+
+  submit(slot, {slot.cmd}, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+  slot.callback = std::move(callback);
+  slot.extent = extent;
+  slot.size = size;
+  slot.pending = true;
+  slot.render_signaled = false;
+  m_next = (m_next + 1) % static_cast<uint32_t>(m_slots.size());
+}
+
+uint32_t FrameReadback::poll() {
+  // Oldest submission is the slot that will be written next
+  uint32_t delivered{0};
+  const auto slot_count = static_cast<uint32_t>(m_slots.size());
+  for (uint32_t i = 0; i < slot_count; i++) {
+    auto& slot = m_slots[(m_next + i) % slot_count];
+    if (!slot.pending) {
+      continue;
+    }
+    if (!slot_complete(slot)) {
+      break;
+    }
+    deliver(slot);
+    delivered++;
+  }
+  return delivered;
+}
+
+void FrameReadback::flush() {
+  const auto slot_count = static_cast<uint32_t>(m_slots.size());
+  for (uint32_t i = 0; i < slot_count; i++) {
+    auto& slot = m_slots[(m_next + i) % slot_count];
+    if (slot.pending) {
+      wait_slot(slot);
+      deliver(slot);
+    }
+  }
+}
+
+void FrameReadback::consume_render_signal(Slot& slot) {
+  // Empty submission that unsignals the semaphore.  The slot completes without a callback.
+  submit(slot, {}, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+  slot.callback = {};
+  slot.extent = {};
+  slot.size = 0;
+  slot.pending = true;
+  slot.render_signaled = false;
+  m_next = (m_next + 1) % static_cast<uint32_t>(m_slots.size());
+}
+
+void FrameReadback::submit(Slot& slot, const std::vector<VkCommandBuffer>& cmd_buffers,
+                           const VkPipelineStageFlags wait_stage) const {
+  const SemaphoreWait render_wait{slot.render_semaphore(), 0, wait_stage};
+  if (m_timeline) {
+    slot.future = m_timeline->submit(cmd_buffers, {render_wait});
+    return;
+  }
+
+  auto submit_info = CreateInfo::vk_submit_info();
+  submit_info.waitSemaphoreCount = 1;
+  submit_info.pWaitSemaphores = &render_wait.semaphore;
+  submit_info.pWaitDstStageMask = &render_wait.stage;
+  submit_info.commandBufferCount = static_cast<uint32_t>(cmd_buffers.size());
+  submit_info.pCommandBuffers = cmd_buffers.data();
+
+  const VkFence fence = slot.fence();
+  VkCheck(vkResetFences(m_vk_device, 1, &fence), Exceptions::VkStartupException());
+  VkCheck(vkQueueSubmit(m_queue.handle, 1, &submit_info, fence), Exceptions::VkStartupException());
+}
+
+bool FrameReadback::slot_complete(const Slot& slot) const {
+  if (m_timeline) {
+    return slot.future.ready();
+  }
+  return vkGetFenceStatus(m_vk_device, slot.fence()) == VK_SUCCESS;
+}
+
+void FrameReadback::wait_slot(Slot& slot) const {
+  if (m_timeline) {
+    static_cast<void>(slot.future.wait());
+    return;
+  }
+  const VkFence fence = slot.fence();
+  VkCheck(vkWaitForFences(m_vk_device, 1, &fence, VK_TRUE, UINT64_MAX), Exceptions::VkStartupException());
+}
+
+void FrameReadback::deliver(Slot& slot) const {
+  // No-op for host coherent memory
+  if (slot.size > 0) {
+    VkCheck(vmaInvalidateAllocation(m_allocator, slot.allocation, 0, slot.size), Exceptions::VkStartupException());
+  }
+
+  slot.pending = false;
+  if (slot.callback) {
+    slot.callback(std::span<const std::byte>{slot.mapped, static_cast<size_t>(slot.size)}, slot.extent);
+  }
+}
+
+}  // namespace VkStartup
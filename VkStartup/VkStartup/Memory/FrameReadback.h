@@ -0,0 +1,100 @@
+#pragma once
+#include "VkStartup/Context/Context.h"
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace VkStartup {
+
+// Asynchronous GPU to CPU image readback.  Copies are recorded on the transfer queue into a
+// ring of persistently mapped host buffers.  Once a slot's copy completes, the callback gets
+// a span over the mapped memory (no copy), so reading back frame N overlaps rendering N + 1.
+//
+// Usage per frame:
+//   ctx.end_frame(id, {cmd}, {readback.render_semaphore()});
+//   readback.mark_signaled();  // Only once the submission signaling it was made
+//   readback.enqueue(image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, extent, callback);
+//   readback.poll();
+//
+// The transfer queue is usually a different VkQueue than graphics, so the render semaphore
+// is the only thing ordering the copy after rendering.  The image must be accessible from
+// the transfer queue family (offscreen targets are).
+class FrameReadback {
+ public:
+  // 'data' is only valid for the duration of the callback
+  using Callback = std::function<void(std::span<const std::byte> data, VkExtent2D extent)>;
+
+  explicit FrameReadback(const VkContext& ctx, VkDeviceSize slot_size, uint32_t slot_count = 3);
+  // Delivers outstanding readbacks (see 'flush')
+  ~FrameReadback();
+
+  FrameReadback(const FrameReadback& source) = delete;
+  FrameReadback& operator=(const FrameReadback& rhs) = delete;
+  FrameReadback(FrameReadback&& source) noexcept = delete;
+  FrameReadback& operator=(FrameReadback&& rhs) noexcept = delete;
+
+  // Binary semaphore the render submission must signal before the next 'enqueue'.  The copy
+  // waits on it.  An unsignaled semaphore is handed out again (e.g. 'end_frame' was skipped).
+  // If 'enqueue' is skipped after the signal was submitted, the next call consumes the
+  // pending signal before handing out a semaphore again.
+  [[nodiscard]] VkSemaphore render_semaphore();
+
+  // Records that a submission signaling 'render_semaphore' was made
+  void mark_signaled();
+
+  // Submits a copy of the color image into the next slot.  Requires 'mark_signaled' for this
+  // frame.  If every slot is still pending, this blocks until the oldest completes (its
+  // callback is invoked first).
+  void enqueue(VkImage image, VkImageLayout layout, VkExtent2D extent, Callback callback,
+               VkDeviceSize texel_size = 4);
+
+  // Invokes callbacks for completed readbacks, in submission order, without blocking.
+  // Returns the number of callbacks invoked.
+  uint32_t poll();
+
+  // Blocks until every outstanding readback has been delivered
+  void flush();
+
+ private:
+  struct Slot {
+    VmaBufferHandle buffer{};
+    VmaAllocation allocation{VK_NULL_HANDLE};
+    const std::byte* mapped{nullptr};
+    // Timeline submission of the slot; the fence is only used without timeline semaphores
+    GpuFuture future{};
+    VkFenceHandle fence{};
+    VkSemaphoreHandle render_semaphore{};
+    VkCommandBuffer cmd{VK_NULL_HANDLE};
+    Callback callback{};
+    VkExtent2D extent = {};
+    VkDeviceSize size{0};
+    bool pending{false};
+    // A submission signaling 'render_semaphore' was made & no wait consumed it yet
+    bool render_signaled{false};
+  };
+
+  void init(uint32_t slot_count);
+  void consume_render_signal(Slot& slot);
+  // Waits on the slot's render semaphore & signals its fence or timeline
+  void submit(Slot& slot, const std::vector<VkCommandBuffer>& cmd_buffers, VkPipelineStageFlags wait_stage) const;
+  [[nodiscard]] bool slot_complete(const Slot& slot) const;
+  void wait_slot(Slot& slot) const;
+  void deliver(Slot& slot) const;
+
+  VkDevice m_vk_device{VK_NULL_HANDLE};
+  VmaAllocator m_allocator{VK_NULL_HANDLE};
+  QueueIndexHandle m_queue{};
+  // Null without timeline semaphores.  Submissions through it are serialized with other
+  // submissions to the transfer queue & tracked by the deletion queue.
+  QueueTimeline* m_timeline{nullptr};
+  VkDeviceSize m_slot_size{0};
+
+  VkCommandPoolHandle m_cmd_pool{};
+  std::vector<Slot> m_slots{};
+  uint32_t m_next{0};
+};
+
+}  // namespace VkStartup
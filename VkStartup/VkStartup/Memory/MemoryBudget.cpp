@@ -0,0 +1,105 @@
+#include "VkStartup/Memory/MemoryBudget.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+#include <ranges>
+#include <string>
+#include <utility>
+
+namespace VkStartup {
+
+MemoryBudget::MemoryBudget(VmaAllocator allocator, VkPhysicalDevice physical_device, const bool budget_extension,
+                           std::vector<float> thresholds)
+    : m_allocator{allocator}, m_budget_extension{budget_extension}, m_thresholds{std::move(thresholds)} {
+  vkGetPhysicalDeviceMemoryProperties(physical_device, &m_memory_properties);
+  std::ranges::sort(m_thresholds);
+  m_heaps = query();
+  m_levels.resize(m_heaps.size(), 0);
+  for (const auto& heap : m_heaps) {
+    m_levels[heap.heap_index] = level(heap.pressure());
+  }
+}
+
+void MemoryBudget::update(const uint32_t frame_index) {
+  // Lets VMA refresh the driver budget (VK_EXT_memory_budget is queried every few frames)
+  vmaSetCurrentFrameIndex(m_allocator, frame_index);
+  auto heaps = query();
+
+  // Callbacks are invoked outside the lock so they can query or unregister
+  std::vector<std::pair<HeapBudget, uint32_t>> crossed{};
+  std::vector<PressureCallback> callbacks{};
+  {
+    const std::lock_guard lock{m_mutex};
+    for (const auto& heap : heaps) {
+      const uint32_t heap_level = level(heap.pressure());
+      if (heap_level != m_levels[heap.heap_index]) {
+        m_levels[heap.heap_index] = heap_level;
+        crossed.emplace_back(heap, heap_level);
+      }
+    }
+    m_heaps = std::move(heaps);
+    if (!crossed.empty()) {
+      for (const auto& callback : m_callbacks | std::views::values) {
+        callbacks.push_back(callback);
+      }
+    }
+  }
+
+  for (const auto& [heap, heap_level] : crossed) {
+    VkInfo("Memory heap " + std::to_string(heap.heap_index) + " pressure level " + std::to_string(heap_level) +
+           " (" + std::to_string(heap.usage >> 20) + " / " + std::to_string(heap.budget >> 20) + " MiB)");
+    for (const auto& callback : callbacks) {
+      callback(heap, heap_level);
+    }
+  }
+}
+
+std::vector<HeapBudget> MemoryBudget::heaps() const {
+  const std::lock_guard lock{m_mutex};
+  return m_heaps;
+}
+
+std::vector<HeapBudget> MemoryBudget::query() const {
+  std::vector<VmaBudget> budgets(m_memory_properties.memoryHeapCount);
+  vmaGetHeapBudgets(m_allocator, budgets.data());
+
+  std::vector<HeapBudget> heaps(budgets.size());
+  for (uint32_t i = 0; i < static_cast<uint32_t>(budgets.size()); i++) {
+    auto& heap = heaps[i];
+    const auto& [statistics, usage, budget] = budgets[i];
+    heap.heap_index = i;
+    heap.flags = m_memory_properties.memoryHeaps[i].flags;
+    heap.usage = usage;
+    heap.budget = budget;
+    heap.block_count = statistics.blockCount;
+    heap.allocation_count = statistics.allocationCount;
+    heap.block_bytes = statistics.blockBytes;
+    heap.allocation_bytes = statistics.allocationBytes;
+  }
+  return heaps;
+}
+
+uint32_t MemoryBudget::add_callback(PressureCallback callback) {
+  const std::lock_guard lock{m_mutex};
+  const uint32_t id = m_next_callback++;
+  m_callbacks.emplace(id, std::move(callback));
+  return id;
+}
+
+void MemoryBudget::remove_callback(const uint32_t id) {
+  const std::lock_guard lock{m_mutex};
+  m_callbacks.erase(id);
+}
+
+const std::vector<float>& MemoryBudget::thresholds() const {
+  return m_thresholds;
+}
+
+bool MemoryBudget::budget_extension() const {
+  return m_budget_extension;
+}
+
+uint32_t MemoryBudget::level(const float pressure) const {
+  return static_cast<uint32_t>(std::ranges::upper_bound(m_thresholds, pressure) - m_thresholds.begin());
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,79 @@
+#pragma once
+#include "VkShared/MemAlloc.h"
+#include <vulkan/vulkan_core.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace VkStartup {
+
+struct HeapBudget {
+  uint32_t heap_index{0};
+  VkMemoryHeapFlags flags{0};
+  // Bytes used by this process on the heap (every allocation, not only VMA's) and the bytes it
+  // can use before the driver starts paging.  Without VK_EXT_memory_budget these are VMA
+  // estimates: usage counts VMA blocks and the budget is 80% of the heap size.
+  VkDeviceSize usage{0};
+  VkDeviceSize budget{0};
+  // VMA statistics
+  uint32_t block_count{0};
+  uint32_t allocation_count{0};
+  VkDeviceSize block_bytes{0};
+  VkDeviceSize allocation_bytes{0};
+
+  [[nodiscard]] float pressure() const {
+    return budget > 0 ? static_cast<float>(static_cast<double>(usage) / static_cast<double>(budget)) : 0.0f;
+  }
+};
+
+// Per heap memory telemetry of the VMA allocator with pressure callbacks.  'update' refreshes
+// the budgets (once per frame from 'InitContext::begin_frame') and invokes the callbacks of
+// every heap whose pressure crossed a threshold since the last update, in either direction.
+// 'level' is the number of thresholds at or below the current pressure (0 = below all).
+class MemoryBudget {
+ public:
+  using PressureCallback = std::function<void(const HeapBudget& heap, uint32_t level)>;
+
+  explicit MemoryBudget(VmaAllocator allocator, VkPhysicalDevice physical_device, bool budget_extension,
+                        std::vector<float> thresholds);
+
+  MemoryBudget(const MemoryBudget& source) = delete;
+  MemoryBudget& operator=(const MemoryBudget& rhs) = delete;
+  MemoryBudget(MemoryBudget&& source) noexcept = delete;
+  MemoryBudget& operator=(MemoryBudget&& rhs) noexcept = delete;
+
+  // Queries the budgets and fires callbacks for level changes
+  void update(uint32_t frame_index);
+
+  // Budgets as of the last 'update'
+  [[nodiscard]] std::vector<HeapBudget> heaps() const;
+  // Queries the budgets without updating levels or firing callbacks
+  [[nodiscard]] std::vector<HeapBudget> query() const;
+
+  // Returns an id for 'remove_callback'.  Callbacks run on the thread calling 'update'.
+  uint32_t add_callback(PressureCallback callback);
+  void remove_callback(uint32_t id);
+
+  [[nodiscard]] const std::vector<float>& thresholds() const;
+  // VK_EXT_memory_budget is enabled (budgets come from the driver)
+  [[nodiscard]] bool budget_extension() const;
+
+ private:
+  [[nodiscard]] uint32_t level(float pressure) const;
+
+  VmaAllocator m_allocator{VK_NULL_HANDLE};
+  VkPhysicalDeviceMemoryProperties m_memory_properties = {};
+  bool m_budget_extension{false};
+  // Ascending
+  std::vector<float> m_thresholds{};
+
+  mutable std::mutex m_mutex{};
+  std::vector<HeapBudget> m_heaps{};
+  std::vector<uint32_t> m_levels{};
+  std::map<uint32_t, PressureCallback> m_callbacks{};
+  uint32_t m_next_callback{0};
+};
+
+}  // namespace VkStartup
@@ -0,0 +1,80 @@
+#include "VkStartup/Memory/StagingRing.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Exceptions.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+
+namespace VkStartup {
+
+StagingRing::StagingRing(VmaAllocator allocator, const VkDeviceSize capacity)
+    : m_allocator{allocator}, m_capacity{std::max<VkDeviceSize>(capacity, 1)} {
+  const auto buffer_info = CreateInfo::vk_buffer_create_info(m_capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+  const auto alloc_info = CreateInfo::vma_allocation_create_info(
+      VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+  VmaAllocationInfo allocation_info = {};
+  m_buffer = VmaBufferHandle{buffer_info, alloc_info, m_allocator, &m_allocation, &allocation_info};
+  m_mapped = static_cast<std::byte*>(allocation_info.pMappedData);
+}
+
+std::optional<StagingRegion> StagingRing::allocate(const VkDeviceSize size, const VkDeviceSize alignment,
+                                                   const uint64_t token) {
+  const VkDeviceSize align = std::max<VkDeviceSize>(alignment, 1);
+  const auto align_up = [align](const VkDeviceSize value) { return (value + align - 1) / align * align; };
+  if (m_spans.empty()) {
+    m_head = 0;
+    m_tail = 0;
+  }
+
+  // Free space is [head, capacity) + [0, tail) when the head is ahead of the tail, otherwise
+  // [head, tail).  Head == tail with regions in flight means the ring is full.
+  std::optional<VkDeviceSize> offset{};
+  if (m_spans.empty() || m_head > m_tail) {
+    if (align_up(m_head) + size <= m_capacity) {
+      offset = align_up(m_head);
+    } else if (size <= m_tail) {
+      offset = 0;
+    }
+  } else if (m_head < m_tail && align_up(m_head) + size <= m_tail) {
+    offset = align_up(m_head);
+  }
+  if (!offset) {
+    return std::nullopt;
+  }
+
+  m_head = *offset + size;
+  if (!m_spans.empty() && m_spans.back().token == token) {
+    m_spans.back().end = m_head;
+  } else {
+    m_spans.push_back(Span{token, m_head});
+  }
+  return StagingRegion{m_buffer(), *offset, size, m_mapped + *offset};
+}
+
+void StagingRing::release(const uint64_t completed_token) {
+  while (!m_spans.empty() && m_spans.front().token <= completed_token) {
+    m_tail = m_spans.front().end;
+    m_spans.pop_front();
+  }
+}
+
+void StagingRing::flush(const StagingRegion& region) const {
+  VkCheck(vmaFlushAllocation(m_allocator, m_allocation, region.offset, region.size), Exceptions::VkStartupException());
+}
+
+VkBuffer StagingRing::buffer() const {
+  return m_buffer();
+}
+
+VkDeviceSize StagingRing::capacity() const {
+  return m_capacity;
+}
+
+VkDeviceSize StagingRing::used() const {
+  if (m_spans.empty()) {
+    return 0;
+  }
+  return m_head > m_tail ? m_head - m_tail : m_capacity - m_tail + m_head;
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,63 @@
+#pragma once
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace VkStartup {
+
+struct StagingRegion {
+  VkBuffer buffer{VK_NULL_HANDLE};
+  VkDeviceSize offset{0};
+  VkDeviceSize size{0};
+  std::byte* mapped{nullptr};
+};
+
+// Fixed size, persistently mapped staging buffer allocated as a ring.  Every region is tagged
+// with the token of the submission that reads it and is reclaimed by 'release' once that
+// submission completed.  Tokens must be non decreasing.
+class StagingRing {
+ public:
+  explicit StagingRing(VmaAllocator allocator, VkDeviceSize capacity);
+
+  StagingRing(const StagingRing& source) = delete;
+  StagingRing& operator=(const StagingRing& rhs) = delete;
+  StagingRing(StagingRing&& source) noexcept = delete;
+  StagingRing& operator=(StagingRing&& rhs) noexcept = delete;
+
+  // Empty when the ring doesn't have 'size' contiguous bytes free
+  [[nodiscard]] std::optional<StagingRegion> allocate(VkDeviceSize size, VkDeviceSize alignment, uint64_t token);
+
+  // Reclaims the regions of every token up to 'completed_token'
+  void release(uint64_t completed_token);
+
+  // Makes host writes visible to the device (no-op for host coherent memory)
+  void flush(const StagingRegion& region) const;
+
+  [[nodiscard]] VkBuffer buffer() const;
+  [[nodiscard]] VkDeviceSize capacity() const;
+  // Bytes in use, including wrap around & alignment padding
+  [[nodiscard]] VkDeviceSize used() const;
+
+ private:
+  struct Span {
+    uint64_t token{0};
+    // End of the token's last region; the tail moves here once the token completed
+    VkDeviceSize end{0};
+  };
+
+  VmaAllocator m_allocator{VK_NULL_HANDLE};
+  VkDeviceSize m_capacity{0};
+  VmaBufferHandle m_buffer{};
+  VmaAllocation m_allocation{VK_NULL_HANDLE};
+  std::byte* m_mapped{nullptr};
+
+  VkDeviceSize m_head{0};
+  VkDeviceSize m_tail{0};
+  // Oldest first
+  std::deque<Span> m_spans{};
+};
+
+}  // namespace VkStartup
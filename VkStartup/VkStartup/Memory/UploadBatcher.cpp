@@ -0,0 +1,401 @@
+#include "VkStartup/Memory/UploadBatcher.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Exceptions.h"
+#include "VkShared/Macros.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <string>
+
+namespace VkStartup {
+
+namespace {
+
+// Staging offset of buffer copies
+constexpr VkDeviceSize staging_alignment{16};
+
+// Staging offsets of image copies must be multiples of 4 and of the texel size (e.g. 12 for
+// R32G32B32)
+VkDeviceSize image_staging_alignment(const VkDeviceSize texel_size) {
+  return std::lcm<VkDeviceSize>(std::max<VkDeviceSize>(texel_size, 1), 4);
+}
+
+VkImageSubresourceRange subresource_range(const VkImageSubresourceLayers& layers) {
+  return VkImageSubresourceRange{layers.aspectMask, layers.mipLevel, 1, layers.baseArrayLayer, layers.layerCount};
+}
+
+}  // namespace
+
+UploadBatcher::UploadBatcher(const VkContext& ctx, const VkDeviceSize staging_size)
+    : m_vk_device{ctx.device()},
+      m_transfer_queue{ctx.queue(VkShared::Enums::QueueFamily::Transfer)},
+      m_graphics_queue{ctx.queue(VkShared::Enums::QueueFamily::Graphics)},
+      m_ownership_transfer{m_transfer_queue.family_index != m_graphics_queue.family_index},
+      m_staging{ctx.mem_alloc(), staging_size} {
+  if (!ctx.timelines.empty()) {
+    m_transfer_timeline = &ctx.timeline(VkShared::Enums::QueueFamily::Transfer);
+    m_graphics_timeline = &ctx.timeline(VkShared::Enums::QueueFamily::Graphics);
+  }
+  m_transfer_pool = VkCommandPoolHandle{
+      CreateInfo::vk_command_pool_create_info(m_transfer_queue.family_index,
+                                              VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT),
+      m_vk_device};
+  if (m_ownership_transfer) {
+    m_graphics_pool = VkCommandPoolHandle{
+        CreateInfo::vk_command_pool_create_info(m_graphics_queue.family_index,
+                                                VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT),
+        m_vk_device};
+  }
+}
+
+UploadBatcher::~UploadBatcher() {
+  // Requests that were never flushed are dropped
+  for (const auto& batch : m_batches) {
+    if (!batch.pending) {
+      continue;
+    }
+    if (m_transfer_timeline) {
+      static_cast<void>(batch.future.wait());
+    } else {
+      const VkFence fence = batch.fence();
+      vkWaitForFences(m_vk_device, 1, &fence, VK_TRUE, UINT64_MAX);
+    }
+  }
+}
+
+UploadToken UploadBatcher::upload_buffer(VkBuffer buffer, const std::span<const std::byte> data,
+                                         const VkDeviceSize offset) {
+  if (data.empty()) {
+    return m_completed_token;
+  }
+  const auto region = stage(data, staging_alignment);
+
+  BufferCopy copy{};
+  copy.buffer = buffer;
+  copy.region = VkBufferCopy{region.offset, offset, region.size};
+  m_buffer_copies.push_back(copy);
+  return m_next_token;
+}
+
+UploadToken UploadBatcher::upload_image(VkImage image, const std::span<const std::byte> data, const VkExtent3D extent,
+                                        const VkImageSubresourceLayers subresource,
+                                        const VkImageLayout final_layout, const VkDeviceSize texel_size) {
+  if (data.empty()) {
+    return m_completed_token;
+  }
+  const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * extent.depth *
+                            subresource.layerCount * texel_size;
+  if (data.size() != size) {
+    VkError("Image upload of " + std::to_string(data.size()) + " bytes doesn't match the " + std::to_string(size) +
+            " bytes of its extent");
+    throw Exceptions::VkStartupException();
+  }
+  const auto region = stage(data, image_staging_alignment(texel_size));
+
+  ImageCopy copy{};
+  copy.image = image;
+  copy.region.bufferOffset = region.offset;
+  copy.region.bufferRowLength = 0;
+  copy.region.bufferImageHeight = 0;
+  copy.region.imageSubresource = subresource;
+  copy.region.imageOffset = VkOffset3D{0, 0, 0};
+  copy.region.imageExtent = extent;
+  copy.final_layout = final_layout;
+  m_image_copies.push_back(copy);
+  return m_next_token;
+}
+
+UploadToken UploadBatcher::flush() {
+  if (m_buffer_copies.empty() && m_image_copies.empty()) {
+    return m_next_token - 1;
+  }
+  auto& batch = free_batch();
+
+  const auto begin_info = CreateInfo::vk_command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+  VkCheck(vkBeginCommandBuffer(batch.transfer_cmd, &begin_info), Exceptions::VkStartupException());
+  record_transfer(batch.transfer_cmd);
+  VkCheck(vkEndCommandBuffer(batch.transfer_cmd), Exceptions::VkStartupException());
+  if (m_ownership_transfer) {
+    VkCheck(vkBeginCommandBuffer(batch.acquire_cmd, &begin_info), Exceptions::VkStartupException());
+    record_acquire(batch.acquire_cmd);
+    VkCheck(vkEndCommandBuffer(batch.acquire_cmd), Exceptions::VkStartupException());
+  }
+
+  if (m_transfer_timeline) {
+    submit(batch);
+  } else {
+    submit_fenced(batch);
+  }
+
+  batch.token = m_next_token++;
+  batch.pending = true;
+  m_buffer_copies.clear();
+  m_image_copies.clear();
+  return batch.token;
+}
+
+void UploadBatcher::submit(Batch& batch) const {
+  // Timeline submissions are tracked by the deletion queue & serialized with other submissions
+  // to the same queue
+  batch.future = m_transfer_timeline->submit({batch.transfer_cmd});
+  if (m_ownership_transfer) {
+    // The graphics queue acquires ownership once the transfer submission released it
+    batch.future = m_graphics_timeline->submit({batch.acquire_cmd}, {batch.future.gpu_wait()});
+  }
+}
+
+void UploadBatcher::submit_fenced(Batch& batch) const {
+  const VkFence fence = batch.fence();
+  VkCheck(vkResetFences(m_vk_device, 1, &fence), Exceptions::VkStartupException());
+
+  auto transfer_submit = CreateInfo::vk_submit_info();
+  transfer_submit.commandBufferCount = 1;
+  transfer_submit.pCommandBuffers = &batch.transfer_cmd;
+  if (!m_ownership_transfer) {
+    VkCheck(vkQueueSubmit(m_transfer_queue.handle, 1, &transfer_submit, fence), Exceptions::VkStartupException());
+  } else {
+    // The graphics queue acquires ownership once the transfer submission released it
+    const VkSemaphore released = batch.released();
+    transfer_submit.signalSemaphoreCount = 1;
+    transfer_submit.pSignalSemaphores = &released;
+    VkCheck(vkQueueSubmit(m_transfer_queue.handle, 1, &transfer_submit, VK_NULL_HANDLE),
+            Exceptions::VkStartupException());
+
+    constexpr VkPipelineStageFlags wait_stage{VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+    auto acquire_submit = CreateInfo::vk_submit_info();
+    acquire_submit.waitSemaphoreCount = 1;
+    acquire_submit.pWaitSemaphores = &released;
+    acquire_submit.pWaitDstStageMask = &wait_stage;
+    acquire_submit.commandBufferCount = 1;
+    acquire_submit.pCommandBuffers = &batch.acquire_cmd;
+    VkCheck(vkQueueSubmit(m_graphics_queue.handle, 1, &acquire_submit, fence), Exceptions::VkStartupException());
+  }
+}
+
+bool UploadBatcher::completed(const UploadToken token) {
+  retire(false);
+  return token <= m_completed_token;
+}
+
+void UploadBatcher::wait(const UploadToken token) {
+  if (token >= m_next_token) {
+    static_cast<void>(flush());
+  }
+  while (!completed(token)) {
+    retire(true);
+  }
+}
+
+GpuFuture UploadBatcher::future(const UploadToken token) {
+  if (!m_transfer_timeline) {
+    VkError("UploadBatcher::future requires timeline semaphores");
+    throw Exceptions::VkStartupException();
+  }
+  if (token >= m_next_token) {
+    static_cast<void>(flush());
+  }
+  const auto itr =
+      std::ranges::find_if(m_batches, [token](const Batch& batch) { return batch.pending && batch.token == token; });
+  return itr != m_batches.end() ? itr->future : GpuFuture{};
+}
+
+bool UploadBatcher::ownership_transfer() const {
+  return m_ownership_transfer;
+}
+
+const StagingRing& UploadBatcher::staging() const {
+  return m_staging;
+}
+
+StagingRegion UploadBatcher::stage(const std::span<const std::byte> data, const VkDeviceSize alignment) {
+  if (data.size() > m_staging.capacity()) {
+    VkError("Upload of " + std::to_string(data.size()) + " bytes exceeds the staging ring size of " +
+            std::to_string(m_staging.capacity()) + " bytes");
+    throw Exceptions::VkStartupException();
+  }
+
+  auto region = m_staging.allocate(data.size(), alignment, m_next_token);
+  while (!region) {
+    // Submit what is staged, then wait for the oldest submission to free space
+    static_cast<void>(flush());
+    retire(true);
+    region = m_staging.allocate(data.size(), alignment, m_next_token);
+  }
+
+  std::memcpy(region->mapped, data.data(), data.size());
+  m_staging.flush(*region);
+  return *region;
+}
+
+UploadBatcher::Batch& UploadBatcher::free_batch() {
+  retire(false);
+  const auto itr = std::ranges::find_if(m_batches, [](const Batch& batch) { return !batch.pending; });
+  if (itr != m_batches.end()) {
+    return *itr;
+  }
+
+  Batch batch{};
+  const auto transfer_info = CreateInfo::vk_command_buffer_allocate_info(m_transfer_pool(),
+                                                                         VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1);
+  VkCheck(vkAllocateCommandBuffers(m_vk_device, &transfer_info, &batch.transfer_cmd),
+          Exceptions::VkStartupException());
+  if (m_ownership_transfer) {
+    const auto acquire_info = CreateInfo::vk_command_buffer_allocate_info(m_graphics_pool(),
+                                                                          VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1);
+    VkCheck(vkAllocateCommandBuffers(m_vk_device, &acquire_info, &batch.acquire_cmd),
+            Exceptions::VkStartupException());
+  }
+  if (!m_transfer_timeline) {
+    if (m_ownership_transfer) {
+      batch.released = VkSemaphoreHandle{CreateInfo::vk_semaphore_create_info(), m_vk_device};
+    }
+    batch.fence = VkFenceHandle{CreateInfo::vk_fence_create_info(0), m_vk_device};
+  }
+  return m_batches.emplace_back(std::move(batch));
+}
+
+void UploadBatcher::record_transfer(VkCommandBuffer cmd) const {
+  // Previous image contents are discarded
+  std::vector<VkImageMemoryBarrier> to_transfer{};
+  for (const auto& [image, region, final_layout] : m_image_copies) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = subresource_range(region.imageSubresource);
+    to_transfer.push_back(barrier);
+  }
+  if (!to_transfer.empty()) {
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, static_cast<uint32_t>(to_transfer.size()), to_transfer.data());
+  }
+
+  for (const auto& [buffer, region] : m_buffer_copies) {
+    vkCmdCopyBuffer(cmd, m_staging.buffer(), buffer, 1, &region);
+  }
+  for (const auto& [image, region, final_layout] : m_image_copies) {
+    vkCmdCopyBufferToImage(cmd, m_staging.buffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+  }
+
+  // Release to the graphics family, or make the writes visible to later commands
+  const uint32_t src_family = m_ownership_transfer ? m_transfer_queue.family_index : VK_QUEUE_FAMILY_IGNORED;
+  const uint32_t dst_family = m_ownership_transfer ? m_graphics_queue.family_index : VK_QUEUE_FAMILY_IGNORED;
+  const VkAccessFlags dst_access = m_ownership_transfer ? 0 : VK_ACCESS_MEMORY_READ_BIT;
+  const VkPipelineStageFlags dst_stage =
+      m_ownership_transfer ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+  std::vector<VkBufferMemoryBarrier> buffer_barriers{};
+  for (const auto& [buffer, region] : m_buffer_copies) {
+    VkBufferMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = dst_access;
+    barrier.srcQueueFamilyIndex = src_family;
+    barrier.dstQueueFamilyIndex = dst_family;
+    barrier.buffer = buffer;
+    barrier.offset = region.dstOffset;
+    barrier.size = region.size;
+    buffer_barriers.push_back(barrier);
+  }
+  std::vector<VkImageMemoryBarrier> image_barriers{};
+  for (const auto& [image, region, final_layout] : m_image_copies) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = dst_access;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = final_layout;
+    barrier.srcQueueFamilyIndex = src_family;
+    barrier.dstQueueFamilyIndex = dst_family;
+    barrier.image = image;
+    barrier.subresourceRange = subresource_range(region.imageSubresource);
+    image_barriers.push_back(barrier);
+  }
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, dst_stage, 0, 0, nullptr,
+                       static_cast<uint32_t>(buffer_barriers.size()), buffer_barriers.data(),
+                       static_cast<uint32_t>(image_barriers.size()), image_barriers.data());
+}
+
+void UploadBatcher::record_acquire(VkCommandBuffer cmd) const {
+  // Must match the release barriers of 'record_transfer'
+  std::vector<VkBufferMemoryBarrier> buffer_barriers{};
+  for (const auto& [buffer, region] : m_buffer_copies) {
+    VkBufferMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    barrier.srcQueueFamilyIndex = m_transfer_queue.family_index;
+    barrier.dstQueueFamilyIndex = m_graphics_queue.family_index;
+    barrier.buffer = buffer;
+    barrier.offset = region.dstOffset;
+    barrier.size = region.size;
+    buffer_barriers.push_back(barrier);
+  }
+  std::vector<VkImageMemoryBarrier> image_barriers{};
+  for (const auto& [image, region, final_layout] : m_image_copies) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = final_layout;
+    barrier.srcQueueFamilyIndex = m_transfer_queue.family_index;
+    barrier.dstQueueFamilyIndex = m_graphics_queue.family_index;
+    barrier.image = image;
+    barrier.subresourceRange = subresource_range(region.imageSubresource);
+    image_barriers.push_back(barrier);
+  }
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr,
+                       static_cast<uint32_t>(buffer_barriers.size()), buffer_barriers.data(),
+                       static_cast<uint32_t>(image_barriers.size()), image_barriers.data());
+}
+
+void UploadBatcher::retire(const bool block) {
+  if (block) {
+    // Oldest pending batch
+    const auto oldest = std::ranges::min_element(m_batches, [](const Batch& lhs, const Batch& rhs) {
+      return (lhs.pending ? lhs.token : UINT64_MAX) < (rhs.pending ? rhs.token : UINT64_MAX);
+    });
+    if (oldest != m_batches.end() && oldest->pending) {
+      wait_batch(*oldest);
+    }
+  }
+
+  // Every token below the oldest incomplete one is complete
+  UploadToken oldest_pending{m_next_token};
+  for (auto& batch : m_batches) {
+    if (!batch.pending) {
+      continue;
+    }
+    if (batch_complete(batch)) {
+      batch.pending = false;
+    } else {
+      oldest_pending = std::min(oldest_pending, batch.token);
+    }
+  }
+  m_completed_token = oldest_pending - 1;
+  m_staging.release(m_completed_token);
+}
+
+bool UploadBatcher::batch_complete(const Batch& batch) const {
+  if (m_transfer_timeline) {
+    return batch.future.ready();
+  }
+  return vkGetFenceStatus(m_vk_device, batch.fence()) == VK_SUCCESS;
+}
+
+void UploadBatcher::wait_batch(const Batch& batch) const {
+  if (m_transfer_timeline) {
+    static_cast<void>(batch.future.wait());
+    return;
+  }
+  const VkFence fence = batch.fence();
+  VkCheck(vkWaitForFences(m_vk_device, 1, &fence, VK_TRUE, UINT64_MAX), Exceptions::VkStartupException());
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,126 @@
+#pragma once
+#include "VkStartup/Context/Context.h"
+#include "VkStartup/Handle/UsingHandle.h"
+#include "VkStartup/Memory/StagingRing.h"
+#include "VkStartup/Sync/TimelineSemaphore.h"
+#include <vulkan/vulkan_core.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace VkStartup {
+
+// Completion token of an upload.  Tokens increase with every submission; 0 is always complete.
+using UploadToken = uint64_t;
+
+// Batched uploads on the transfer queue.  Requests are copied into a 'StagingRing' and
+// recorded into a single command buffer & submission per 'flush'.  When the transfer and
+// graphics queue families differ, ownership of the destinations is released on the transfer
+// queue and acquired on the graphics queue (exclusive sharing mode resources).
+//
+// A destination can be used on the graphics queue once its token completed, or by a graphics
+// submission waiting on 'future(token).gpu_wait()'.  With timeline semaphores, submissions go
+// through the context's queue timelines, so they are serialized with the renderer and tracked
+// by the deletion queue.  Otherwise they are fenced and graphics queue submissions must be
+// externally synchronized with the renderer (same as 'FrameReadback').
+//
+//   const auto token = uploader.upload_buffer(vertex_buffer, vertices);
+//   uploader.upload_image(texture, texels, extent, {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1});
+//   uploader.flush();
+//   ...
+//   if (uploader.completed(token)) { ... }
+class UploadBatcher {
+ public:
+  explicit UploadBatcher(const VkContext& ctx, VkDeviceSize staging_size = 64ull << 20);
+  ~UploadBatcher();
+
+  UploadBatcher(const UploadBatcher& source) = delete;
+  UploadBatcher& operator=(const UploadBatcher& rhs) = delete;
+  UploadBatcher(UploadBatcher&& source) noexcept = delete;
+  UploadBatcher& operator=(UploadBatcher&& rhs) noexcept = delete;
+
+  // Queues a copy into 'buffer' at 'offset'.  When the staging ring is full the pending
+  // batch is flushed and the oldest submissions are waited on.  Throws when 'data' is larger
+  // than the staging ring.
+  UploadToken upload_buffer(VkBuffer buffer, std::span<const std::byte> data, VkDeviceSize offset = 0);
+
+  // Queues a copy of tightly packed texels (uncompressed formats) into one mip level of 'image'.
+  // The previous contents of the subresource are discarded; it ends in 'final_layout'.  Throws
+  // when 'data' doesn't hold exactly 'extent' * 'texel_size' bytes for every layer.
+  UploadToken upload_image(VkImage image, std::span<const std::byte> data, VkExtent3D extent,
+                           VkImageSubresourceLayers subresource,
+                           VkImageLayout final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                           VkDeviceSize texel_size = 4);
+
+  // Submits the pending requests.  Returns their token (the last token when nothing is pending).
+  UploadToken flush();
+
+  // Polls without blocking
+  [[nodiscard]] bool completed(UploadToken token);
+  // Flushes first if 'token' is still pending
+  void wait(UploadToken token);
+
+  // Submission that completes 'token' (flushes first if it is still pending).  Ready once the
+  // token completed.  Requires timeline semaphores.
+  [[nodiscard]] GpuFuture future(UploadToken token);
+
+  // Families differ & ownership is transferred to the graphics queue family
+  [[nodiscard]] bool ownership_transfer() const;
+  [[nodiscard]] const StagingRing& staging() const;
+
+ private:
+  struct BufferCopy {
+    VkBuffer buffer{VK_NULL_HANDLE};
+    VkBufferCopy region = {};
+  };
+  struct ImageCopy {
+    VkImage image{VK_NULL_HANDLE};
+    VkBufferImageCopy region = {};
+    VkImageLayout final_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+  };
+  struct Batch {
+    VkCommandBuffer transfer_cmd{VK_NULL_HANDLE};
+    VkCommandBuffer acquire_cmd{VK_NULL_HANDLE};
+    // Timeline submission of the batch (the acquire submission when ownership is transferred)
+    GpuFuture future{};
+    // Only used without timeline semaphores
+    VkFenceHandle fence{};
+    VkSemaphoreHandle released{};
+    UploadToken token{0};
+    bool pending{false};
+  };
+
+  [[nodiscard]] StagingRegion stage(std::span<const std::byte> data, VkDeviceSize alignment);
+  [[nodiscard]] Batch& free_batch();
+  void record_transfer(VkCommandBuffer cmd) const;
+  void record_acquire(VkCommandBuffer cmd) const;
+  void submit(Batch& batch) const;
+  void submit_fenced(Batch& batch) const;
+  [[nodiscard]] bool batch_complete(const Batch& batch) const;
+  void wait_batch(const Batch& batch) const;
+  // Releases completed batches; blocks on the oldest pending batch when 'block' is set
+  void retire(bool block);
+
+  VkDevice m_vk_device{VK_NULL_HANDLE};
+  QueueIndexHandle m_transfer_queue{};
+  QueueIndexHandle m_graphics_queue{};
+  bool m_ownership_transfer{false};
+  // Null without timeline semaphores.  Timelines are heap allocated, so the pointers survive
+  // moving the owning context.
+  QueueTimeline* m_transfer_timeline{nullptr};
+  QueueTimeline* m_graphics_timeline{nullptr};
+
+  StagingRing m_staging;
+  VkCommandPoolHandle m_transfer_pool{};
+  VkCommandPoolHandle m_graphics_pool{};
+  // Submission order
+  std::vector<Batch> m_batches{};
+
+  std::vector<BufferCopy> m_buffer_copies{};
+  std::vector<ImageCopy> m_image_copies{};
+  UploadToken m_next_token{1};
+  UploadToken m_completed_token{0};
+};
+
+}  // namespace VkStartup
@@ -30,23 +30,41 @@ namespace VkStartup::CreateInfo {
   return info;
 }
 
-[[nodiscard]] inline VkDebugUtilsMessengerCreateInfoEXT vk_debug_utils_messenger_create_info() {
+[[nodiscard]] inline VkDebugUtilsMessengerCreateInfoEXT vk_debug_utils_messenger_create_info(
+    const VkDebugUtilsMessageSeverityFlagsEXT severities = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+                                                           VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+    const VkDebugUtilsMessageTypeFlagsEXT types = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+                                                  VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                                                  VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+    void* user_data = nullptr) {
   VkDebugUtilsMessengerCreateInfoEXT info = {};
   info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-  info.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
-                         VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
-  info.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
-                     VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
-  info.pUserData = nullptr;
+  info.messageSeverity = severities;
+  info.messageType = types;
+  info.pUserData = user_data;
   info.pNext = nullptr;
   return info;
 }
 
-[[nodiscard]] inline VkDeviceQueueCreateInfo vk_device_queue_create_info(const uint32_t family_idx) {
+[[nodiscard]] inline VkValidationFeaturesEXT vk_validation_features(
+    const std::vector<VkValidationFeatureEnableEXT>& enabled) {
+  VkValidationFeaturesEXT info = {};
+  info.sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT;
+  info.enabledValidationFeatureCount = static_cast<uint32_t>(enabled.size());
+  info.pEnabledValidationFeatures = enabled.data();
+  info.disabledValidationFeatureCount = 0;
+  info.pDisabledValidationFeatures = nullptr;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkDeviceQueueCreateInfo vk_device_queue_create_info(const uint32_t family_idx,
+                                                                          const std::vector<float>& priorities) {
   VkDeviceQueueCreateInfo info = {};
   info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
   info.queueFamilyIndex = family_idx;
-  info.queueCount = 1;
+  info.queueCount = static_cast<uint32_t>(priorities.size());
+  info.pQueuePriorities = priorities.data();
   info.pNext = nullptr;
   return info;
 }
@@ -93,10 +111,70 @@ namespace VkStartup::CreateInfo {
   return info;
 }
 
+[[nodiscard]] inline VkImageCreateInfo vk_image_create_info(const VkFormat format, const VkExtent2D extent,
+                                                            const VkImageUsageFlags usage,
+                                                            const std::vector<uint32_t>& unique_queue_family_indices) {
+  VkImageCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  info.imageType = VK_IMAGE_TYPE_2D;
+  info.format = format;
+  info.extent = VkExtent3D{extent.width, extent.height, 1};
+  info.mipLevels = 1;
+  info.arrayLayers = 1;
+  info.samples = VK_SAMPLE_COUNT_1_BIT;
+  info.tiling = VK_IMAGE_TILING_OPTIMAL;
+  info.usage = usage;
+  info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  if (unique_queue_family_indices.size() > 1) {
+    // Concurrent sharing
+    info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    info.queueFamilyIndexCount = static_cast<uint32_t>(unique_queue_family_indices.size());
+    info.pQueueFamilyIndices = unique_queue_family_indices.data();
+  } else {
+    // Exclusive sharing
+    info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    info.queueFamilyIndexCount = 0;
+    info.pQueueFamilyIndices = nullptr;
+  }
+  return info;
+}
+
+[[nodiscard]] inline VkBufferCreateInfo vk_buffer_create_info(const VkDeviceSize size, const VkBufferUsageFlags usage) {
+  VkBufferCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  info.size = size;
+  info.usage = usage;
+  info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VmaAllocationCreateInfo vma_allocation_create_info(const VmaMemoryUsage usage,
+                                                                        const VmaAllocationCreateFlags flags) {
+  VmaAllocationCreateInfo info = {};
+  info.usage = usage;
+  info.flags = flags;
+  return info;
+}
+
+[[nodiscard]] inline VmaPoolCreateInfo vma_pool_create_info(const uint32_t memory_type_index,
+                                                           const VmaPoolCreateFlags flags,
+                                                           const VkDeviceSize block_size = 0,
+                                                           const size_t max_block_count = 0) {
+  VmaPoolCreateInfo info = {};
+  info.memoryTypeIndex = memory_type_index;
+  info.flags = flags;
+  info.blockSize = block_size;
+  info.maxBlockCount = max_block_count;
+  return info;
+}
+
 [[nodiscard]] inline VmaAllocatorCreateInfo vma_allocator_info(VkInstance vk_instance, VkDevice vk_device,
                                                                VkPhysicalDevice vk_physical_device,
-                                                               const uint32_t vk_api_version) {
+                                                               const uint32_t vk_api_version,
+                                                               const VmaAllocatorCreateFlags flags = 0) {
   VmaAllocatorCreateInfo info = {};
+  info.flags = flags;
   info.instance = vk_instance;
   info.device = vk_device;
   info.physicalDevice = vk_physical_device;
@@ -118,4 +196,147 @@ namespace VkStartup::CreateInfo {
   return info;
 }
 
+[[nodiscard]] inline VkPipelineCacheCreateInfo vk_pipeline_cache_create_info(const size_t initial_data_size,
+                                                                            const void* initial_data) {
+  VkPipelineCacheCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  info.initialDataSize = initial_data_size;
+  info.pInitialData = initial_data;
+  return info;
+}
+
+[[nodiscard]] inline VkSemaphoreCreateInfo vk_semaphore_create_info() {
+  VkSemaphoreCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkTimelineSemaphoreSubmitInfo vk_timeline_semaphore_submit_info() {
+  VkTimelineSemaphoreSubmitInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkSemaphoreWaitInfo vk_semaphore_wait_info() {
+  VkSemaphoreWaitInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  info.flags = 0;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkSemaphoreSignalInfo vk_semaphore_signal_info() {
+  VkSemaphoreSignalInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkFenceCreateInfo vk_fence_create_info(const VkFenceCreateFlags flags) {
+  VkFenceCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  info.flags = flags;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkSubmitInfo vk_submit_info() {
+  VkSubmitInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkPresentInfoKHR vk_present_info() {
+  VkPresentInfoKHR info = {};
+  info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkCommandPoolCreateInfo vk_command_pool_create_info(const uint32_t family_idx,
+                                                                        const VkCommandPoolCreateFlags flags) {
+  VkCommandPoolCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  info.queueFamilyIndex = family_idx;
+  info.flags = flags;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkCommandBufferAllocateInfo vk_command_buffer_allocate_info(VkCommandPool pool,
+                                                                                const VkCommandBufferLevel level,
+                                                                                const uint32_t count) {
+  VkCommandBufferAllocateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  info.commandPool = pool;
+  info.level = level;
+  info.commandBufferCount = count;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkHeadlessSurfaceCreateInfoEXT vk_headless_surface_create_info() {
+  VkHeadlessSurfaceCreateInfoEXT info = {};
+  info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+  info.flags = 0;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkCommandBufferBeginInfo vk_command_buffer_begin_info(const VkCommandBufferUsageFlags flags) {
+  VkCommandBufferBeginInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  info.flags = flags;
+  info.pInheritanceInfo = nullptr;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkPhysicalDeviceFeatures2 vk_physical_device_features2() {
+  VkPhysicalDeviceFeatures2 info = {};
+  info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkPhysicalDeviceDynamicRenderingFeatures vk_physical_device_dynamic_rendering_features() {
+  VkPhysicalDeviceDynamicRenderingFeatures info = {};
+  info.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkRenderingAttachmentInfo vk_rendering_attachment_info() {
+  VkRenderingAttachmentInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+  info.resolveMode = VK_RESOLVE_MODE_NONE;
+  info.pNext = nullptr;
+  return info;
+}
+
+[[nodiscard]] inline VkRenderingInfo vk_rendering_info() {
+  VkRenderingInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+  info.layerCount = 1;
+  info.pNext = nullptr;
+  return info;
+}
+
+// Chain into VkGraphicsPipelineCreateInfo::pNext (renderPass must be VK_NULL_HANDLE)
+[[nodiscard]] inline VkPipelineRenderingCreateInfo vk_pipeline_rendering_create_info(
+    const std::vector<VkFormat>& color_formats, const VkFormat depth_format, const VkFormat stencil_format) {
+  VkPipelineRenderingCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+  info.colorAttachmentCount = static_cast<uint32_t>(color_formats.size());
+  info.pColorAttachmentFormats = color_formats.data();
+  info.depthAttachmentFormat = depth_format;
+  info.stencilAttachmentFormat = stencil_format;
+  info.viewMask = 0;
+  info.pNext = nullptr;
+  return info;
+}
+
 }  // namespace VkStartup::CreateInfo
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdio>
+#include <string>
+
+namespace VkStartup::Json {
+
+// Escapes a value for use inside a JSON string literal
+[[nodiscard]] inline std::string escape(const std::string& value) {
+  std::string escaped{};
+  escaped.reserve(value.size());
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+          escaped += buffer;
+        } else {
+          escaped += c;
+        }
+    }
+  }
+  return escaped;
+}
+
+}  // namespace VkStartup::Json
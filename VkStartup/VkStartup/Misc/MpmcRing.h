@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace VkStartup {
+
+// Bounded lock-free multi-producer / multi-consumer queue (Vyukov).  Each cell carries a
+// sequence number that tells producers and consumers whose turn it is, so neither side
+// blocks: 'try_push' fails when the ring is full and 'try_pop' fails when it is empty.
+// Capacity is rounded up to a power of two.
+template <typename T>
+class MpmcRing {
+ public:
+  explicit MpmcRing(const size_t capacity)
+      : m_capacity{std::bit_ceil(std::max<size_t>(capacity, 2))},
+        m_mask{m_capacity - 1},
+        m_cells{std::make_unique<Cell[]>(m_capacity)} {
+    for (size_t i = 0; i < m_capacity; i++) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcRing(const MpmcRing& source) = delete;
+  MpmcRing& operator=(const MpmcRing& rhs) = delete;
+  MpmcRing(MpmcRing&& source) noexcept = delete;
+  MpmcRing& operator=(MpmcRing&& rhs) noexcept = delete;
+
+  [[nodiscard]] bool try_push(const T& value) {
+    size_t position = m_enqueue.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = m_cells[position & m_mask];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+      if (diff == 0) {
+        if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          cell.value = value;
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  [[nodiscard]] bool try_pop(T& value) {
+    size_t position = m_dequeue.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = m_cells[position & m_mask];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+      if (diff == 0) {
+        if (m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          value = cell.value;
+          cell.sequence.store(position + m_capacity, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = m_dequeue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  [[nodiscard]] size_t capacity() const {
+    return m_capacity;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence{0};
+    T value{};
+  };
+
+  size_t m_capacity{0};
+  size_t m_mask{0};
+  std::unique_ptr<Cell[]> m_cells{};
+  alignas(64) std::atomic<size_t> m_enqueue{0};
+  alignas(64) std::atomic<size_t> m_dequeue{0};
+};
+
+}  // namespace VkStartup
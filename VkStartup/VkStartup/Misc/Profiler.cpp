@@ -0,0 +1,107 @@
+#include "VkStartup/Misc/Profiler.h"
+#include "VkStartup/Misc/Json.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace VkStartup {
+
+namespace {
+
+thread_local StartupProfiler* active_profiler{nullptr};
+
+double to_ms(const std::chrono::nanoseconds value) {
+  return std::chrono::duration<double, std::milli>(value).count();
+}
+
+double to_us(const std::chrono::nanoseconds value) {
+  return std::chrono::duration<double, std::micro>(value).count();
+}
+
+}  // namespace
+
+// Activation
+StartupProfiler::Activation::Activation(StartupProfiler& profiler) : m_previous{active_profiler} {
+  if (profiler.m_spans.empty()) {
+    profiler.m_origin = Clock::now();
+  }
+  active_profiler = &profiler;
+}
+
+StartupProfiler::Activation::~Activation() {
+  active_profiler = m_previous;
+}
+
+// StartupProfiler
+const std::vector<ProfileSpan>& StartupProfiler::spans() const {
+  return m_spans;
+}
+
+std::chrono::nanoseconds StartupProfiler::total() const {
+  std::chrono::nanoseconds total{0};
+  for (const auto& span : m_spans) {
+    if (span.depth == 0) {
+      total += span.duration;
+    }
+  }
+  return total;
+}
+
+std::string StartupProfiler::summary() const {
+  std::ostringstream stream{};
+  stream << std::fixed << std::setprecision(3);
+  for (const auto& [name, depth, start, duration] : m_spans) {
+    stream << std::string(static_cast<size_t>(depth) * 2, ' ') << name << ": " << to_ms(duration) << " ms\n";
+  }
+  return stream.str();
+}
+
+std::string StartupProfiler::chrome_trace() const {
+  std::ostringstream stream{};
+  stream << std::fixed << std::setprecision(3);
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < m_spans.size(); i++) {
+    const auto& span = m_spans[i];
+    stream << (i == 0 ? "" : ",") << "{\"name\":\"" << Json::escape(span.name)
+           << "\",\"cat\":\"VkStartup\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" << to_us(span.start)
+           << ",\"dur\":" << to_us(span.duration) << "}";
+  }
+  stream << "]}";
+  return stream.str();
+}
+
+bool StartupProfiler::write_chrome_trace(const std::filesystem::path& path) const {
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  file << chrome_trace();
+  return static_cast<bool>(file);
+}
+
+StartupProfiler* StartupProfiler::active() {
+  return active_profiler;
+}
+
+size_t StartupProfiler::begin(std::string name) {
+  m_spans.push_back(ProfileSpan{std::move(name), m_depth++, Clock::now() - m_origin, std::chrono::nanoseconds{0}});
+  return m_spans.size() - 1;
+}
+
+void StartupProfiler::end(const size_t index) {
+  auto& span = m_spans[index];
+  span.duration = (Clock::now() - m_origin) - span.start;
+  m_depth--;
+}
+
+// ProfileScope
+ProfileScope::ProfileScope(std::string name) : m_profiler{active_profiler} {
+  if (m_profiler) {
+    m_index = m_profiler->begin(std::move(name));
+  }
+}
+
+ProfileScope::~ProfileScope() {
+  if (m_profiler) {
+    m_profiler->end(m_index);
+  }
+}
+
+}  // namespace VkStartup
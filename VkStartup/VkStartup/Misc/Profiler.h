@@ -0,0 +1,76 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace VkStartup {
+
+struct ProfileSpan {
+  std::string name{};
+  uint32_t depth{0};
+  // Relative to the start of the profile
+  std::chrono::nanoseconds start{0};
+  std::chrono::nanoseconds duration{0};
+};
+
+// Wall time spans recorded on one thread.  While a profiler is active (see 'Activation'),
+// every 'ProfileScope' on that thread records a span; otherwise scopes are no-ops.  Spans
+// are stored in start order, so nesting is given by 'depth'.
+class StartupProfiler {
+ public:
+  class Activation {
+   public:
+    explicit Activation(StartupProfiler& profiler);
+    ~Activation();
+
+    Activation(const Activation& source) = delete;
+    Activation& operator=(const Activation& rhs) = delete;
+    Activation(Activation&& source) noexcept = delete;
+    Activation& operator=(Activation&& rhs) noexcept = delete;
+
+   private:
+    StartupProfiler* m_previous{nullptr};
+  };
+
+  [[nodiscard]] const std::vector<ProfileSpan>& spans() const;
+  [[nodiscard]] std::chrono::nanoseconds total() const;
+
+  // One line per span, indented by depth
+  [[nodiscard]] std::string summary() const;
+
+  // Chrome trace event format (chrome://tracing, Perfetto)
+  [[nodiscard]] std::string chrome_trace() const;
+  bool write_chrome_trace(const std::filesystem::path& path) const;
+
+  [[nodiscard]] static StartupProfiler* active();
+
+ private:
+  friend class ProfileScope;
+  [[nodiscard]] size_t begin(std::string name);
+  void end(size_t index);
+
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point m_origin{};
+  std::vector<ProfileSpan> m_spans{};
+  uint32_t m_depth{0};
+};
+
+// Records a span for the enclosing scope on the thread's active profiler
+class ProfileScope {
+ public:
+  explicit ProfileScope(std::string name);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope& source) = delete;
+  ProfileScope& operator=(const ProfileScope& rhs) = delete;
+  ProfileScope(ProfileScope&& source) noexcept = delete;
+  ProfileScope& operator=(ProfileScope&& rhs) noexcept = delete;
+
+ private:
+  StartupProfiler* m_profiler{nullptr};
+  size_t m_index{0};
+};
+
+}  // namespace VkStartup
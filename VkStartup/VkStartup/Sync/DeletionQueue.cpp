@@ -0,0 +1,92 @@
+#include "VkStartup/Sync/DeletionQueue.h"
+#include "VkStartup/Context/Context.h"
+#include <algorithm>
+#include <ranges>
+
+namespace VkStartup {
+
+DeletionQueue::DeletionQueue(const VkContext& ctx) : m_vk_device{ctx.device()} {
+  for (const auto& timeline : ctx.timelines | std::views::values) {
+    m_timelines.push_back(timeline.get());
+  }
+}
+
+void DeletionQueue::push(std::unique_ptr<Retired> retired, const uint32_t frame_delay) {
+  auto point = retirement_point();
+  std::lock_guard lock{m_mutex};
+  m_entries.push_back(Entry{std::move(point), m_frame + frame_delay, std::move(retired)});
+}
+
+void DeletionQueue::advance_frame() {
+  std::lock_guard lock{m_mutex};
+  m_frame++;
+}
+
+uint32_t DeletionQueue::collect() {
+  // Destroyed outside of the lock
+  std::vector<std::unique_ptr<Retired>> expired{};
+  {
+    std::lock_guard lock{m_mutex};
+    const bool any_due =
+        std::ranges::any_of(m_entries, [this](const Entry& entry) { return entry.frame <= m_frame; });
+    if (!any_due) {
+      return 0;
+    }
+    if (m_timelines.empty()) {
+      vkDeviceWaitIdle(m_vk_device);
+    }
+
+    // Points are taken in submission order, so the first pending point ends the scan.  Entries
+    // held for presentation are skipped.
+    for (auto itr = m_entries.begin(); itr != m_entries.end() && passed(itr->point);) {
+      if (itr->frame > m_frame) {
+        ++itr;
+        continue;
+      }
+      expired.push_back(std::move(itr->retired));
+      itr = m_entries.erase(itr);
+    }
+  }
+  return static_cast<uint32_t>(expired.size());
+}
+
+void DeletionQueue::flush() {
+  std::deque<Entry> entries{};
+  bool presenting{false};
+  {
+    std::lock_guard lock{m_mutex};
+    entries.swap(m_entries);
+    presenting = std::ranges::any_of(entries, [this](const Entry& entry) { return entry.frame > m_frame; });
+  }
+  if (m_timelines.empty() || presenting) {
+    if (!entries.empty()) {
+      vkDeviceWaitIdle(m_vk_device);
+    }
+    return;
+  }
+  for (const auto& entry : entries) {
+    for (const auto& future : entry.point) {
+      static_cast<void>(future.wait());
+    }
+  }
+}
+
+size_t DeletionQueue::size() const {
+  std::lock_guard lock{m_mutex};
+  return m_entries.size();
+}
+
+std::vector<GpuFuture> DeletionQueue::retirement_point() const {
+  std::vector<GpuFuture> point{};
+  point.reserve(m_timelines.size());
+  for (const auto* timeline : m_timelines) {
+    point.emplace_back(timeline, timeline->submitted());
+  }
+  return point;
+}
+
+bool DeletionQueue::passed(const std::vector<GpuFuture>& point) {
+  return std::ranges::all_of(point, [](const GpuFuture& future) { return future.ready(); });
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,94 @@
+#pragma once
+#include "VkStartup/Sync/TimelineSemaphore.h"
+#include <vulkan/vulkan_core.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace VkStartup {
+
+struct VkContext;
+
+// Deferred destruction for handles the GPU may still be using.  A retired handle is tagged
+// with the latest submission on every queue timeline and destroyed by 'collect' once all of
+// them have completed.  'InitContext::begin_frame' collects every frame.
+//
+// Only submissions made through the queue timelines are tracked ('end_frame' uses them).
+// Presentation isn't tracked by any timeline, so handles the presentation engine may still
+// use (swapchains, render finished semaphores) are additionally held for a number of frames
+// ('advance_frame' is called once per context frame by 'InitContext::begin_frame').
+//
+// Without timeline semaphores, 'collect' waits for the device to go idle before destroying
+// pending handles (the behavior before deferred destruction existed).
+class DeletionQueue {
+ public:
+  // Must be created after the context's queue timelines
+  explicit DeletionQueue(const VkContext& ctx);
+  ~DeletionQueue() = default;
+
+  DeletionQueue(const DeletionQueue& source) = delete;
+  DeletionQueue& operator=(const DeletionQueue& rhs) = delete;
+  DeletionQueue(DeletionQueue&& source) noexcept = delete;
+  DeletionQueue& operator=(DeletionQueue&& rhs) noexcept = delete;
+
+  // Takes ownership of a handle (e.g. 'VkImageViewHandle') or a vector of handles.  It isn't
+  // destroyed before 'frame_delay' more calls to 'advance_frame'.
+  template <typename T>
+  void retire(T&& handle, const uint32_t frame_delay = 0) {
+    if constexpr (requires { handle.empty(); }) {
+      if (handle.empty()) {
+        return;
+      }
+    } else if constexpr (requires { handle(); }) {
+      if (!handle()) {
+        return;
+      }
+    }
+    push(std::make_unique<RetiredHandle<std::remove_cvref_t<T>>>(std::forward<T>(handle)), frame_delay);
+  }
+
+  void advance_frame();
+
+  // Destroys handles whose submissions have completed.  Returns the number destroyed.
+  uint32_t collect();
+
+  // Waits for every retirement point and destroys everything.  Waits for the device to go
+  // idle if a handle is still held for presentation.
+  void flush();
+
+  [[nodiscard]] size_t size() const;
+
+ private:
+  struct Retired {
+    virtual ~Retired() = default;
+  };
+
+  template <typename T>
+  struct RetiredHandle final : Retired {
+    explicit RetiredHandle(T&& value) : handle(std::move(value)) {
+    }
+    T handle;
+  };
+
+  struct Entry {
+    std::vector<GpuFuture> point{};
+    // First frame (see 'advance_frame') the handle can be destroyed in
+    uint64_t frame{0};
+    std::unique_ptr<Retired> retired{};
+  };
+
+  void push(std::unique_ptr<Retired> retired, uint32_t frame_delay);
+  [[nodiscard]] std::vector<GpuFuture> retirement_point() const;
+  [[nodiscard]] static bool passed(const std::vector<GpuFuture>& point);
+
+  // Timelines are heap allocated, so the pointers survive moving the owning context
+  VkDevice m_vk_device{VK_NULL_HANDLE};
+  std::vector<const QueueTimeline*> m_timelines{};
+  mutable std::mutex m_mutex{};
+  std::deque<Entry> m_entries{};
+  uint64_t m_frame{0};
+};
+
+}  // namespace VkStartup
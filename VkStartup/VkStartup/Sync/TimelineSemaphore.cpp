@@ -0,0 +1,179 @@
+#include "VkStartup/Sync/TimelineSemaphore.h"
+#include "VkStartup/Context/Context.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartup/Misc/Exceptions.h"
+#include "VkShared/Macros.h"
+
+namespace VkStartup {
+
+// TimelineSemaphore
+TimelineSemaphore::TimelineSemaphore(const VkContext& ctx, const uint64_t initial_value)
+    : m_vk_device{ctx.device()},
+      m_wait_semaphores{ctx.wait_semaphores},
+      m_signal_semaphore{ctx.signal_semaphore},
+      m_get_counter_value{ctx.get_semaphore_counter_value} {
+  if (!ctx.phy_device_info.timeline_semaphore) {
+    VkError("Timeline semaphores are not enabled on this device");
+    throw Exceptions::VkStartupException();
+  }
+  m_semaphore = VkTimelineSemaphoreHandle{initial_value, m_vk_device};
+}
+
+VkSemaphore TimelineSemaphore::handle() const {
+  return m_semaphore();
+}
+
+uint64_t TimelineSemaphore::value() const {
+  uint64_t value{0};
+  VkCheck(m_get_counter_value(m_vk_device, m_semaphore(), &value), Exceptions::VkStartupException());
+  return value;
+}
+
+bool TimelineSemaphore::wait(const uint64_t value, const uint64_t timeout) const {
+  const VkSemaphore semaphore = m_semaphore();
+  auto info = CreateInfo::vk_semaphore_wait_info();
+  info.semaphoreCount = 1;
+  info.pSemaphores = &semaphore;
+  info.pValues = &value;
+
+  const auto result = m_wait_semaphores(m_vk_device, &info, timeout);
+  if (result == VK_TIMEOUT) {
+    return false;
+  }
+  VkCheck(result, Exceptions::VkStartupException());
+  return true;
+}
+
+void TimelineSemaphore::signal(const uint64_t value) const {
+  auto info = CreateInfo::vk_semaphore_signal_info();
+  info.semaphore = m_semaphore();
+  info.value = value;
+  VkCheck(m_signal_semaphore(m_vk_device, &info), Exceptions::VkStartupException());
+}
+
+// GpuFuture
+GpuFuture::GpuFuture(const QueueTimeline* timeline, const uint64_t value) : m_timeline{timeline}, m_value{value} {
+}
+
+bool GpuFuture::ready() const {
+  return !m_timeline || m_timeline->completed(m_value);
+}
+
+bool GpuFuture::wait(const uint64_t timeout) const {
+  return !m_timeline || m_timeline->wait(m_value, timeout);
+}
+
+uint64_t GpuFuture::value() const {
+  return m_value;
+}
+
+const QueueTimeline* GpuFuture::timeline() const {
+  return m_timeline;
+}
+
+SemaphoreWait GpuFuture::gpu_wait(const VkPipelineStageFlags stage) const {
+  if (!m_timeline) {
+    return SemaphoreWait{VK_NULL_HANDLE, 0, stage};
+  }
+  return SemaphoreWait{m_timeline->semaphore().handle(), m_value, stage};
+}
+
+// QueueTimeline
+QueueTimeline::QueueTimeline(const VkContext& ctx, const QueueIndexHandle& queue)
+    : m_queue{queue.handle}, m_family_index{queue.family_index}, m_semaphore{ctx, 0} {
+}
+
+GpuFuture QueueTimeline::submit(const std::vector<VkCommandBuffer>& cmd_buffers,
+                                const std::vector<SemaphoreWait>& waits,
+                                const std::vector<VkSemaphore>& signal_semaphores, const VkFence fence) {
+  // Waits (null semaphores are skipped, e.g. a default constructed future)
+  std::vector<VkSemaphore> wait_semaphores{};
+  std::vector<uint64_t> wait_values{};
+  std::vector<VkPipelineStageFlags> wait_stages{};
+  for (const auto& [semaphore, value, stage] : waits) {
+    if (semaphore) {
+      wait_semaphores.push_back(semaphore);
+      wait_values.push_back(value);
+      wait_stages.push_back(stage);
+    }
+  }
+
+  // Signals.  The timeline value is last; values for binary semaphores are ignored.
+  std::vector<VkSemaphore> signals{signal_semaphores};
+  signals.push_back(m_semaphore.handle());
+  std::vector<uint64_t> signal_values(signals.size(), 0);
+
+  std::lock_guard lock{m_submit_mutex};
+  const uint64_t value = m_submitted.load(std::memory_order_relaxed) + 1;
+  signal_values.back() = value;
+
+  auto timeline_info = CreateInfo::vk_timeline_semaphore_submit_info();
+  timeline_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+  timeline_info.pWaitSemaphoreValues = wait_values.data();
+  timeline_info.signalSemaphoreValueCount = static_cast<uint32_t>(signal_values.size());
+  timeline_info.pSignalSemaphoreValues = signal_values.data();
+
+  auto submit_info = CreateInfo::vk_submit_info();
+  submit_info.pNext = &timeline_info;
+  submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+  submit_info.pWaitSemaphores = wait_semaphores.data();
+  submit_info.pWaitDstStageMask = wait_stages.data();
+  submit_info.commandBufferCount = static_cast<uint32_t>(cmd_buffers.size());
+  submit_info.pCommandBuffers = cmd_buffers.data();
+  submit_info.signalSemaphoreCount = static_cast<uint32_t>(signals.size());
+  submit_info.pSignalSemaphores = signals.data();
+
+  VkCheck(vkQueueSubmit(m_queue, 1, &submit_info, fence), Exceptions::VkStartupException());
+  m_submitted.store(value, std::memory_order_release);
+  return GpuFuture{this, value};
+}
+
+uint64_t QueueTimeline::submitted() const {
+  return m_submitted.load(std::memory_order_acquire);
+}
+
+uint64_t QueueTimeline::completed() const {
+  const uint64_t value = m_semaphore.value();
+  observe(value);
+  return value;
+}
+
+bool QueueTimeline::completed(const uint64_t value) const {
+  return m_completed.load(std::memory_order_relaxed) >= value || completed() >= value;
+}
+
+bool QueueTimeline::wait(const uint64_t value, const uint64_t timeout) const {
+  if (m_completed.load(std::memory_order_relaxed) >= value) {
+    return true;
+  }
+  if (!m_semaphore.wait(value, timeout)) {
+    return false;
+  }
+  observe(value);
+  return true;
+}
+
+void QueueTimeline::wait_idle() const {
+  static_cast<void>(wait(submitted()));
+}
+
+void QueueTimeline::observe(const uint64_t value) const {
+  // Monotonic update; concurrent pollers may race
+  uint64_t cached = m_completed.load(std::memory_order_relaxed);
+  while (cached < value && !m_completed.compare_exchange_weak(cached, value, std::memory_order_relaxed)) {
+  }
+}
+
+VkQueue QueueTimeline::queue() const {
+  return m_queue;
+}
+
+uint32_t QueueTimeline::family_index() const {
+  return m_family_index;
+}
+
+const TimelineSemaphore& QueueTimeline::semaphore() const {
+  return m_semaphore;
+}
+
+}  // namespace VkStartup
@@ -0,0 +1,114 @@
+#pragma once
+#include "VkStartup/Handle/UsingHandle.h"
+#include <vulkan/vulkan_core.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace VkStartup {
+
+struct VkContext;
+struct QueueIndexHandle;
+class QueueTimeline;
+
+// Timeline semaphore (Vulkan 1.2 / VK_KHR_timeline_semaphore) with host wait & signal.
+// Requires 'PhysicalDeviceInfo::timeline_semaphore'.
+class TimelineSemaphore {
+ public:
+  TimelineSemaphore() = default;
+  explicit TimelineSemaphore(const VkContext& ctx, uint64_t initial_value = 0);
+
+  [[nodiscard]] VkSemaphore handle() const;
+
+  // Current counter value
+  [[nodiscard]] uint64_t value() const;
+
+  // Returns false if 'timeout' (nanoseconds) expires first
+  [[nodiscard]] bool wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+  // Host signal.  'value' must be greater than the current value.
+  void signal(uint64_t value) const;
+
+ private:
+  VkDevice m_vk_device{VK_NULL_HANDLE};
+  PFN_vkWaitSemaphores m_wait_semaphores{nullptr};
+  PFN_vkSignalSemaphore m_signal_semaphore{nullptr};
+  PFN_vkGetSemaphoreCounterValue m_get_counter_value{nullptr};
+  VkTimelineSemaphoreHandle m_semaphore{};
+};
+
+// Semaphore wait for a submission.  'value' is ignored for binary semaphores.
+struct SemaphoreWait {
+  VkSemaphore semaphore{VK_NULL_HANDLE};
+  uint64_t value{0};
+  VkPipelineStageFlags stage{VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+};
+
+// Completion of one queue submission.  Cheap to copy and poll: the last completed value
+// seen on the queue is cached, so most polls don't call into the driver.  A default
+// constructed future is always ready.
+class GpuFuture {
+ public:
+  GpuFuture() = default;
+  GpuFuture(const QueueTimeline* timeline, uint64_t value);
+
+  [[nodiscard]] bool ready() const;
+  // Returns false if 'timeout' (nanoseconds) expires first
+  [[nodiscard]] bool wait(uint64_t timeout = UINT64_MAX) const;
+
+  [[nodiscard]] uint64_t value() const;
+  [[nodiscard]] const QueueTimeline* timeline() const;
+
+  // Makes another submission (on any queue) wait for this one on the GPU
+  [[nodiscard]] SemaphoreWait gpu_wait(VkPipelineStageFlags stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT) const;
+
+ private:
+  const QueueTimeline* m_timeline{nullptr};
+  uint64_t m_value{0};
+};
+
+// Monotonic submission counter for a queue.  Every submission signals the queue's timeline
+// semaphore with the next value, so completion is tracked without a fence per submission.
+// Submissions through the same timeline are serialized (vkQueueSubmit requires external
+// synchronization of the queue).
+class QueueTimeline {
+ public:
+  explicit QueueTimeline(const VkContext& ctx, const QueueIndexHandle& queue);
+
+  QueueTimeline(const QueueTimeline& source) = delete;
+  QueueTimeline& operator=(const QueueTimeline& rhs) = delete;
+  QueueTimeline(QueueTimeline&& source) noexcept = delete;
+  QueueTimeline& operator=(QueueTimeline&& rhs) noexcept = delete;
+
+  // Waits may mix binary and timeline semaphores.  Binary 'signal_semaphores' and 'fence'
+  // are optional (e.g. presentation or legacy fence waits).
+  GpuFuture submit(const std::vector<VkCommandBuffer>& cmd_buffers, const std::vector<SemaphoreWait>& waits = {},
+                   const std::vector<VkSemaphore>& signal_semaphores = {}, VkFence fence = VK_NULL_HANDLE);
+
+  // Value of the most recent submission
+  [[nodiscard]] uint64_t submitted() const;
+  // Value of the most recent completed submission
+  [[nodiscard]] uint64_t completed() const;
+  [[nodiscard]] bool completed(uint64_t value) const;
+  [[nodiscard]] bool wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+  // Waits for every submission made through this timeline
+  void wait_idle() const;
+
+  [[nodiscard]] VkQueue queue() const;
+  [[nodiscard]] uint32_t family_index() const;
+  [[nodiscard]] const TimelineSemaphore& semaphore() const;
+
+ private:
+  void observe(uint64_t value) const;
+
+  VkQueue m_queue{VK_NULL_HANDLE};
+  uint32_t m_family_index{0};
+  TimelineSemaphore m_semaphore{};
+
+  std::mutex m_submit_mutex{};
+  std::atomic<uint64_t> m_submitted{0};
+  mutable std::atomic<uint64_t> m_completed{0};
+};
+
+}  // namespace VkStartup
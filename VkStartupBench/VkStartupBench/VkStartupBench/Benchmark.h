@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace VkStartupBench {
+
+// Samples of one benchmark in microseconds.  When a sample times a batch of operations,
+// it is divided by the batch size, so every value is the cost of a single operation.
+struct BenchResult {
+  std::string name{};
+  uint32_t batch_size{1};
+  std::vector<double> samples_us{};
+
+  // Nearest rank percentile (0 - 100)
+  [[nodiscard]] double percentile(const double p) const {
+    if (samples_us.empty()) {
+      return 0.0;
+    }
+    auto sorted = samples_us;
+    std::ranges::sort(sorted);
+    const auto rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+  }
+
+  [[nodiscard]] double mean() const {
+    if (samples_us.empty()) {
+      return 0.0;
+    }
+    return std::accumulate(samples_us.begin(), samples_us.end(), 0.0) / static_cast<double>(samples_us.size());
+  }
+
+  [[nodiscard]] std::string json() const {
+    std::string out = "{\"name\": \"" + name + "\", \"unit\": \"us\", \"samples\": " +
+                      std::to_string(samples_us.size()) + ", \"batch_size\": " + std::to_string(batch_size);
+    out += ", \"min\": " + std::to_string(percentile(0.0));
+    out += ", \"p50\": " + std::to_string(percentile(50.0));
+    out += ", \"p90\": " + std::to_string(percentile(90.0));
+    out += ", \"p99\": " + std::to_string(percentile(99.0));
+    out += ", \"max\": " + std::to_string(percentile(100.0));
+    out += ", \"mean\": " + std::to_string(mean()) + "}";
+    return out;
+  }
+};
+
+// Runs 'warmup' untimed iterations followed by 'iterations' timed ones.  Work that should
+// not be measured (setup, teardown) belongs in 'setup' / 'teardown', which run around
+// every iteration outside of the timed region.
+class Benchmark {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Step = std::function<void()>;
+
+  explicit Benchmark(std::string name, const uint32_t iterations, const uint32_t warmup = 1,
+                     const uint32_t batch_size = 1)
+      : m_iterations{iterations}, m_warmup{warmup} {
+    m_result.name = std::move(name);
+    m_result.batch_size = std::max(batch_size, 1u);
+  }
+
+  BenchResult run(const Step& body, const Step& setup = {}, const Step& teardown = {}) {
+    for (uint32_t i = 0; i < m_warmup + m_iterations; i++) {
+      if (setup) {
+        setup();
+      }
+      const auto start = Clock::now();
+      body();
+      const auto elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+      if (teardown) {
+        teardown();
+      }
+      if (i >= m_warmup) {
+        m_result.samples_us.push_back(elapsed / m_result.batch_size);
+      }
+    }
+    return m_result;
+  }
+
+ private:
+  uint32_t m_iterations{0};
+  uint32_t m_warmup{0};
+  BenchResult m_result{};
+};
+
+}  // namespace VkStartupBench
@@ -0,0 +1,13 @@
+#pragma once
+#include <exception>
+
+namespace VkStartupBench::Exceptions {
+
+class VkStartupBenchException final : public std::exception {
+ public:
+  [[nodiscard]] const char* what() const noexcept override {
+    return "VkStartupBench failed";
+  }
+};
+
+}  // namespace VkStartupBench::Exceptions
@@ -0,0 +1,260 @@
+#include "VkStartup/Context/InitContext.h"
+#include "VkStartup/Context/HeadlessSurfaceLoader.h"
+#include "VkStartup/Context/Renderpass.h"
+#include "VkStartup/Misc/CreateInfo.h"
+#include "VkStartupBench/Benchmark.h"
+#include "VkStartupBench/Exceptions.h"
+#include "VkShared/Macros.h"
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct BenchOptions {
+  // Software rasterizers (lavapipe / llvmpipe) are rejected unless explicitly allowed, so
+  // numbers from a CPU device are never mistaken for a hardware baseline.
+  bool allow_software{false};
+  uint32_t iterations{20};
+  uint32_t handle_count{1000};
+  std::string output_path{};
+};
+
+void print_usage() {
+  std::cout << "Usage: VkStartupBench [--allow-software] [--iterations N] [--handles N] [--output file.json]\n"
+               "  --allow-software  run on a CPU device (lavapipe); also enabled by VKSTARTUP_BENCH_ALLOW_SOFTWARE=1\n"
+               "  --iterations N    timed iterations per benchmark (default 20)\n"
+               "  --handles N       handles per THandle move / destroy sample (default 1000)\n"
+               "  --output file     write the JSON report to a file instead of stdout\n";
+}
+
+BenchOptions parse_args(const int argc, char** argv) {
+  BenchOptions options;
+  if (const char* env = std::getenv("VKSTARTUP_BENCH_ALLOW_SOFTWARE"); env && std::strcmp(env, "1") == 0) {
+    options.allow_software = true;
+  }
+
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg{argv[i]};
+    const bool has_value = i + 1 < argc;
+    if (arg == "--allow-software") {
+      options.allow_software = true;
+    } else if (arg == "--iterations" && has_value) {
+      options.iterations = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+    } else if (arg == "--handles" && has_value) {
+      options.handle_count = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+    } else if (arg == "--output" && has_value) {
+      options.output_path = argv[++i];
+    } else {
+      print_usage();
+      throw VkStartupBench::Exceptions::VkStartupBenchException();
+    }
+  }
+  return options;
+}
+
+VkStartup::InitContextOptions context_options(const BenchOptions& bench, const bool validation) {
+  VkStartup::InitContextOptions options;
+  options.api_version = VK_API_VERSION_1_2;
+  options.enable_validation = validation;
+  options.device_policy.allow_software_rasterizer = bench.allow_software;
+  return options;
+}
+
+// Surface ids must be unique for the lifetime of the process
+std::string unique_surface_id() {
+  static uint32_t count{0};
+  return "bench_headless_" + std::to_string(count++);
+}
+
+// Single subpass with one color and one depth attachment (the common forward pass)
+VkStartup::RenderpassData forward_renderpass_data(const VkFormat color_format, const VkFormat depth_format) {
+  static constexpr VkAttachmentReference color_ref{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+  static constexpr VkAttachmentReference depth_ref{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+  VkAttachmentDescription color = {};
+  color.format = color_format;
+  color.samples = VK_SAMPLE_COUNT_1_BIT;
+  color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  color.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  color.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+  VkAttachmentDescription depth = color;
+  depth.format = depth_format;
+  depth.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  depth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+  VkSubpassDescription subpass = {};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.colorAttachmentCount = 1;
+  subpass.pColorAttachments = &color_ref;
+  subpass.pDepthStencilAttachment = &depth_ref;
+
+  VkStartup::RenderpassData data;
+  data.color_attachments = {color};
+  data.depth_attachment = depth;
+  data.depth_attachment_ref = depth_ref;
+  data.subpass_descs = {subpass};
+  return data;
+}
+
+std::vector<VkStartupBench::BenchResult> bench_init_context(const BenchOptions& options, const bool validation) {
+  using VkStartupBench::Benchmark;
+  const std::string name = validation ? "init_context_validation" : "init_context";
+
+  // Construction and destruction are reported separately
+  std::vector<VkStartupBench::BenchResult> results;
+  std::unique_ptr<VkStartup::InitContext> context{};
+  results.push_back(Benchmark{name, options.iterations}.run(
+      [&context, &options, validation] {
+        context = std::make_unique<VkStartup::InitContext>(context_options(options, validation));
+      },
+      {}, [&context] { context.reset(); }));
+  results.push_back(Benchmark{name + "_destroy", options.iterations}.run(
+      [&context] { context.reset(); },
+      [&context, &options, validation] {
+        context = std::make_unique<VkStartup::InitContext>(context_options(options, validation));
+      }));
+  return results;
+}
+
+VkStartupBench::BenchResult bench_remake_swapchain(const BenchOptions& options) {
+  const std::string id = unique_surface_id();
+  auto surface_loader = std::make_unique<VkStartup::HeadlessSurfaceLoader>(id, VkExtent2D{1280, 720});
+  auto& headless = *surface_loader;
+
+  auto context_opt = context_options(options, false);
+  context_opt.required_instance_ext = VkStartup::HeadlessSurfaceLoader::extensions();
+  context_opt.surface_loaders.emplace_back(std::move(surface_loader));
+  VkStartup::InitContext context{std::move(context_opt)};
+
+  // Alternate the extent so every remake is a real resize
+  uint32_t resize{0};
+  return VkStartupBench::Benchmark{"remake_swapchain_headless", options.iterations}.run(
+      [&context, &id] {
+        if (!context.remake_swapchain(id)) {
+          VkError("Headless swapchain has a zero extent");
+          throw VkStartupBench::Exceptions::VkStartupBenchException();
+        }
+      },
+      [&headless, &resize] {
+        const uint32_t delta = resize++ % 2;
+        headless.extent(VkExtent2D{1280 + delta, 720 + delta});
+      },
+      [&context] { context.context().deletion_queue->flush(); });
+}
+
+VkStartupBench::BenchResult bench_create_renderpass(const BenchOptions& options, VkStartup::VkContext& ctx) {
+  constexpr uint32_t batch_size{100};
+  const auto data = forward_renderpass_data(VK_FORMAT_B8G8R8A8_SRGB, ctx.phy_device_info.depth_format);
+
+  // Creation and destruction of each renderpass are both part of the sample
+  return VkStartupBench::Benchmark{"create_renderpass", options.iterations, 1, batch_size}.run([&data, &ctx] {
+    for (uint32_t i = 0; i < batch_size; i++) {
+      const auto renderpass = VkStartup::RenderpassBuilder::create_renderpass(data, ctx.device());
+    }
+  });
+}
+
+std::vector<VkStartupBench::BenchResult> bench_handles(const BenchOptions& options, VkStartup::VkContext& ctx) {
+  using VkStartupBench::Benchmark;
+  const uint32_t count = options.handle_count;
+
+  std::vector<VkStartup::VkSemaphoreHandle> handles{};
+  std::vector<VkStartup::VkSemaphoreHandle> moved{};
+  const auto create_handles = [&handles, &moved, &ctx, count] {
+    moved.clear();
+    handles.clear();
+    handles.reserve(count);
+    moved.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+      handles.emplace_back(VkStartup::CreateInfo::vk_semaphore_create_info(), ctx.device());
+    }
+  };
+
+  std::vector<VkStartupBench::BenchResult> results;
+  results.push_back(Benchmark{"thandle_move", options.iterations, 1, count}.run(
+      [&handles, &moved] {
+        for (auto& handle : handles) {
+          moved.push_back(std::move(handle));
+        }
+      },
+      create_handles));
+  results.push_back(Benchmark{"thandle_destroy", options.iterations, 1, count}.run([&handles] { handles.clear(); },
+                                                                                   create_handles));
+  return results;
+}
+
+std::string report(const VkPhysicalDeviceProperties& properties, const bool validation_active,
+                   const std::vector<VkStartupBench::BenchResult>& results) {
+  std::string out = "{\n  \"device\": \"" + std::string{properties.deviceName} + "\",\n";
+  out += "  \"device_type\": " + std::to_string(properties.deviceType) + ",\n";
+  out += "  \"api_version\": \"" + std::to_string(VK_API_VERSION_MAJOR(properties.apiVersion)) + "." +
+         std::to_string(VK_API_VERSION_MINOR(properties.apiVersion)) + "." +
+         std::to_string(VK_API_VERSION_PATCH(properties.apiVersion)) + "\",\n";
+  out += "  \"driver_version\": " + std::to_string(properties.driverVersion) + ",\n";
+  out += "  \"software\": " + std::string{properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU ? "true" : "false"};
+  out += ",\n  \"validation\": " + std::string{validation_active ? "true" : "false"} + ",\n";
+  out += "  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    out += "    " + results[i].json() + (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  out += "  ]\n}\n";
+  return out;
+}
+
+}  // namespace
+
+int main(const int argc, char** argv) {
+  const auto options = parse_args(argc, argv);
+
+  // Reference context: selects the device and provides the device for the micro benchmarks.
+  // CPU devices are skipped by the selection policy unless --allow-software is given.
+  VkStartup::InitContext reference{context_options(options, false)};
+  auto& ctx = reference.context();
+
+  VkPhysicalDeviceProperties properties = {};
+  vkGetPhysicalDeviceProperties(ctx.phy_device_info.vk_phy_device, &properties);
+
+  std::vector<VkStartupBench::BenchResult> results;
+  const auto append = [&results](std::vector<VkStartupBench::BenchResult> values) {
+    results.insert(results.end(), values.begin(), values.end());
+  };
+
+  append(bench_init_context(options, false));
+
+  // Validation is disabled by InitContext when the layer isn't installed
+  const bool validation_active = VkStartup::InitContext{context_options(options, true)}.context().debugger != nullptr;
+  if (validation_active) {
+    append(bench_init_context(options, true));
+  } else {
+    VkWarning("VK_LAYER_KHRONOS_validation is not available; skipping validation benchmarks");
+  }
+
+  results.push_back(bench_remake_swapchain(options));
+  results.push_back(bench_create_renderpass(options, ctx));
+  append(bench_handles(options, ctx));
+
+  const auto json = report(properties, validation_active, results);
+  if (options.output_path.empty()) {
+    std::cout << json;
+  } else {
+    std::ofstream file{options.output_path};
+    if (!file) {
+      VkError("Unable to open " + options.output_path);
+      return EXIT_FAILURE;
+    }
+    file << json;
+  }
+  return EXIT_SUCCESS;
+}